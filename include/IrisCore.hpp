@@ -171,6 +171,41 @@ IRIS_EXPORT Buffer  Create_strong_buffer        ();
  */
 IRIS_EXPORT Buffer  Create_strong_buffer (size_t buffer_size_in_bytes);
 
+/**
+ * @brief Create a **strong** blank buffer with an initial capacity of @ref "buffer_size_in_bytes" bytes long
+ * using the allocation behaviour defined by @ref flags.
+ * 
+ * Aligned buffers keep their alignment if the data block is later grown. This is
+ * the preferred allocation for pixel data consumed by vectorized routines and,
+ * with BUFFER_CREATE_HUGE_PAGES, for very large caches where TLB pressure matters.
+ * \sa BufferCreateFlags
+ * 
+ * @param buffer_size_in_bytes the initial **capacity** (in bytes). The internal 'size' is '0' bytes
+ * @param flags allocation behaviour bit-mask
+ * @return Valid Iris::Buffer handle with size 0 bytes on success
+ * @return Nullptr on failure
+ */
+IRIS_EXPORT Buffer  Create_strong_buffer (size_t buffer_size_in_bytes, BufferCreateFlags flags);
+
+/**
+ * @brief Create a **strong** blank buffer with an initial capacity of @ref "buffer_size_in_bytes" bytes long
+ * with pages placed on the NUMA node @ref numa_node.
+ * 
+ * Use this on multi-socket systems to allocate tile data on the node of the threads
+ * that will consume it. The node placement is retained if the data block is later grown.
+ * Passing IRIS_NUMA_NODE_ANY places the block on the calling thread's preferred node.
+ * \note On systems with a single NUMA node (or without NUMA support) this is equivalent
+ * to Create_strong_buffer(buffer_size_in_bytes, flags) with page alignment.
+ * \sa Set_thread_numa_node
+ * 
+ * @param buffer_size_in_bytes the initial **capacity** (in bytes). The internal 'size' is '0' bytes
+ * @param flags allocation behaviour bit-mask (BUFFER_CREATE_NUMA_LOCAL is implied)
+ * @param numa_node the NUMA node on which the data block should reside
+ * @return Valid Iris::Buffer handle with size 0 bytes on success
+ * @return Nullptr on failure
+ */
+IRIS_EXPORT Buffer  Create_strong_buffer (size_t buffer_size_in_bytes, BufferCreateFlags flags, uint16_t numa_node);
+
 /**
  * @brief Create a **strong** buffer and copy the data pointed to by @ref dataptr and @ref bytes in length (in bytes).
  * 
@@ -205,6 +240,27 @@ IRIS_EXPORT Buffer Copy_strong_buffer_from_data (const void* data_ptr, size_t by
  */
 IRIS_EXPORT Buffer Wrap_weak_buffer_fom_data (const void* const data_ref, size_t bytes);
 
+/**
+ * @brief Map a region of a file into a **mapped** (read-only) buffer without copying it.
+ * 
+ * The returned buffer owns the mapping and keeps it alive for as long as any copy of the
+ * buffer persists; the region is unmapped when the last copy is destroyed. The file itself
+ * may be closed once the buffer is created. Pages are loaded from the file on first access
+ * by the operating system, so compressed tile bytestreams may be passed directly to a decoder
+ * or a network socket without an intermediate copy.
+ * 
+ * \note The mapped data is read-only. Writing into it or attempting to resize it will fail.
+ * \sa REFERENCE_MAPPED
+ * 
+ * @param file_path path to the file to map
+ * @param offset byte offset of the start of the region within the file (need not be page aligned)
+ * @param bytes length of the region in bytes. This will be the resulting buffer size.
+ * @return Valid Iris::Buffer (**mapped ownership**) handle on success
+ * @return Nullptr on failure
+ * @throws std::runtime_error if the region extends beyond the end of the file
+ */
+IRIS_EXPORT Buffer Map_buffer_from_file (const char* file_path, size_t offset, size_t bytes);
+
 /**
  * @brief Write data into a buffer in a safe manner. 
  * 
@@ -248,6 +304,54 @@ IRIS_EXPORT Result Buffer_get_data (const Buffer& buffer, void*& data, size_t& b
  * \sa BufferReferenceStrength for more details
  */
 IRIS_EXPORT Result Buffer_change_strength (const Buffer& buffer, BufferReferenceStrength strength);
+/**
+ * @brief Attribute a buffer's memory to a subsystem for allocation accounting.
+ * 
+ * The block the buffer currently owns (its bytes and its allocation count) is moved
+ * from its prior tag to the new tag, so each tag's allocations less releases is the
+ * number of live blocks attributed to it.
+ * \sa Get_buffer_allocation_stats(BufferTag)
+ * 
+ * @param buffer handle to the buffer object. Must be a valid buffer.
+ * @param tag accounting tag to assign to the buffer
+ */
+IRIS_EXPORT Result Buffer_set_tag (const Buffer& buffer, BufferTag tag);
+/**
+ * @brief Get the process-wide allocation statistics of strong buffers with the given tag.
+ * 
+ * This is useful for capacity planning and identifying leaks in long running processes.
+ * Values are sampled independently and may be momentarily inconsistent while other
+ * threads allocate.
+ * 
+ * @param tag accounting tag to query
+ */
+IRIS_EXPORT BufferAllocationStats Get_buffer_allocation_stats (BufferTag tag);
+/**
+ * @brief Get the process-wide allocation statistics of all strong buffers (every tag).
+ */
+IRIS_EXPORT BufferAllocationStats Get_buffer_allocation_stats ();
+/**
+ * @brief Get the number of NUMA nodes (memory domains) in the system.
+ * 
+ * @return 1 on single-node systems or where NUMA topology is unavailable
+ */
+IRIS_EXPORT uint16_t Get_numa_node_count ();
+/**
+ * @brief Set the NUMA node preferred by the calling thread for
+ * buffers created with BUFFER_CREATE_NUMA_LOCAL.
+ * 
+ * Async thread pools created with per-node worker groups set this for
+ * each of their workers.
+ * 
+ * @param numa_node preferred node or IRIS_NUMA_NODE_ANY to clear the preference
+ */
+IRIS_EXPORT void Set_thread_numa_node (uint16_t numa_node);
+/**
+ * @brief Get the NUMA node preferred by the calling thread.
+ * 
+ * @return IRIS_NUMA_NODE_ANY if the thread does not prefer a node
+ */
+IRIS_EXPORT uint16_t Get_thread_numa_node ();
 }
 
 #endif /* IrisCore_h */
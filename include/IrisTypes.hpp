@@ -18,14 +18,19 @@
 #define IrisTypes_h
 #include <set>
 #include <map>
+#include <span>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <vector>
 #include <string>
 #include <memory>
 #include <chrono>
+#include <utility>
+#include <optional>
 #include <cstring>
 #include <stdint.h>
+#include <coroutine>
 #include <functional>
 #include <shared_mutex>
 #include <unordered_map>
@@ -62,6 +67,7 @@
 #define TILE_PIX_AREA       65536U
 #define TILE_PIX_BYTES_RGB  196608U
 #define TILE_PIX_BYTES_RGBA 262144U
+#define IRIS_NUMA_NODE_ANY  0xFFFFU
 namespace Iris {
 using BYTE                  = uint8_t;
 using BYTE_ARRAY            = std::vector<BYTE>;
@@ -145,8 +151,11 @@ struct IRIS_EXPORT Version {
  * creation or freeing of that datablock. Strong references have responsibility
  * over the data backing the buffer and will free the memory on buffer destruction.
  * 
+ * Mapped references own a read-only memory mapping of a region of a file, which
+ * is unmapped when the buffer is destroyed.
+ * 
  * \note A weak buffer explicitly is forbidden from resizing the buffer as it *may*
- * invalidate the original pointer.
+ * invalidate the original pointer. Mapped buffers may not be resized either.
  * \warning Changing a strong to weak buffer **requires** the calling program
  * take responsibility for the buffer data pointer. It is now that program's
  * responsibility to free that data once finished or a memory leak will ensue.
@@ -157,6 +166,63 @@ enum IRIS_EXPORT BufferReferenceStrength {
     REFERENCE_WEAK      = 0,
     /// @brief Full ownership. Will free data on buffer destruction. Can resize underlying pointer.
     REFERENCE_STRONG    = 1,
+    /// @brief Owns a read-only file mapping. Will unmap on buffer destruction. Cannot resize or change strength.
+    REFERENCE_MAPPED    = 2,
+};
+/**
+ * @brief Optional allocation behaviour for the data block backing a strong buffer.
+ *
+ * These flags are bit-masks and may be combined. The chosen allocation behaviour
+ * is retained for the life of the buffer, including when the block is grown.
+ *
+ * \note Huge page backing rounds the block capacity up to a multiple of 2 MiB and
+ * should be reserved for large, long-lived allocations such as slide tile caches.
+ */
+enum IRIS_EXPORT BufferCreateFlags : uint8_t {
+    /// @brief Default allocation. Alignment is only guaranteed to alignof(std::max_align_t).
+    BUFFER_CREATE_DEFAULT       = 0,
+    /// @brief Align the data block to a 64-byte boundary (cache line and widest SIMD vector).
+    BUFFER_CREATE_ALIGNED       = 0x01,
+    /// @brief Align to 2 MiB and request transparent huge page backing (where supported).
+    BUFFER_CREATE_HUGE_PAGES    = 0x02,
+    /// @brief Page-align and place the block on a NUMA node: the node passed to Create_strong_buffer or,
+    /// if none is given, the node preferred by the calling thread (see Set_thread_numa_node).
+    BUFFER_CREATE_NUMA_LOCAL    = 0x04,
+};
+/**
+ * @brief Optional label attributing a buffer's memory to a subsystem for
+ * allocation accounting (see Get_buffer_allocation_stats).
+ */
+enum IRIS_EXPORT BufferTag : uint8_t {
+    /// @brief Memory not attributed to a specific subsystem (default)
+    BUFFER_TAG_UNTAGGED         = 0,
+    /// @brief Decoded or compressed slide tile cache entries
+    BUFFER_TAG_TILE_CACHE       = 1,
+    /// @brief Slide encoder working memory
+    BUFFER_TAG_ENCODER          = 2,
+    /// @brief Slide annotation data
+    BUFFER_TAG_ANNOTATION       = 3,
+    /// @brief Network transfer buffers
+    BUFFER_TAG_NETWORK          = 4,
+    BUFFER_TAG_MAX_ENUM,
+};
+/**
+ * @brief Process-wide memory accounting of strong buffer data blocks.
+ *
+ * Only memory owned by strong buffers is counted; weak wraps of foreign
+ * data and file mappings do not consume heap memory and are excluded.
+ */
+struct IRIS_EXPORT BufferAllocationStats {
+    /// @brief Bytes currently held by live strong buffers (block capacity, not size)
+    size_t              liveBytes       = 0;
+    /// @brief Greatest value liveBytes has reached
+    size_t              peakBytes       = 0;
+    /// @brief Number of data blocks allocated or adopted by strong buffers
+    uint64_t            allocations     = 0;
+    /// @brief Number of data blocks released by strong buffers
+    uint64_t            releases        = 0;
+    /// @brief Number of times a data block was resized (reallocated)
+    uint64_t            reallocations   = 0;
 };
 /**
  * @brief Reference counted data object used to wrap datablocks.
@@ -171,8 +237,8 @@ enum IRIS_EXPORT BufferReferenceStrength {
  *  as they were created for exclusive use by Iris developers and use of these methods
  *  comes with risk.
  *
- *  \warning Buffer is currently NOT safe for concurrent use on muplitple threads.
- *  This will be fixed in future updates.
+ *  \warning Buffer is NOT safe for concurrent use on muplitple threads unless
+ *  the concurrent append methods of __INTERNAL__Buffer are used by all writers.
  */
 using Buffer = std::shared_ptr<class __INTERNAL__Buffer>;
 /**
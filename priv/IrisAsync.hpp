@@ -11,28 +11,592 @@
 #ifndef IRIS_CONCURRENCY
 #define IRIS_CONCURRENCY std::thread::hardware_concurrency()
 #endif
+#ifndef IRIS_ASYNC_SPIN_ITERATIONS
+#define IRIS_ASYNC_SPIN_ITERATIONS 2048U
+#endif
+#ifndef IRIS_ASYNC_STARVATION_INTERVAL
+#define IRIS_ASYNC_STARVATION_INTERVAL 32U
+#endif
+#ifndef IRIS_INLINE_LAMBDA_SIZE
+#define IRIS_INLINE_LAMBDA_SIZE 64U
+#endif
+#ifndef IRIS_ASYNC_RECYCLED_BLOCKS
+#define IRIS_ASYNC_RECYCLED_BLOCKS 1024U
+#endif
+#ifndef IRIS_ASYNC_TIMER_SLOTS
+#define IRIS_ASYNC_TIMER_SLOTS 512U
+#endif
+#ifndef IRIS_ASYNC_TIMER_RESOLUTION_US
+#define IRIS_ASYNC_TIMER_RESOLUTION_US 1000U
+#endif
+#ifndef IRIS_LATENCY_RANGE_BITS
+#define IRIS_LATENCY_RANGE_BITS 40U
+#endif
+#ifndef IRIS_LATENCY_PRECISION_BITS
+#define IRIS_LATENCY_PRECISION_BITS 3U
+#endif
+#define IRIS_LATENCY_BUCKETS \
+((IRIS_LATENCY_RANGE_BITS - IRIS_LATENCY_PRECISION_BITS + 1U) << IRIS_LATENCY_PRECISION_BITS)
 
 namespace Iris {
 namespace Async {
 using Fence         = std::shared_ptr<struct __INTERNAL__Fence>;
+using CancelToken   = std::shared_ptr<struct __INTERNAL__CancelToken>;
 using ThreadPool    = std::shared_ptr<class __INTERNAL__Pool>;
 using TaskList      = Iris::FIFO2::Queue<struct Callback>;
+using CpuSet        = std::vector<uint32_t>;
+
+/**
+ * @brief Thread pool creation parameters.
+ */
+struct ThreadPoolCreateInfo {
+    /// @brief Number of worker threads in the pool.
+    uint32_t                        threads         = IRIS_CONCURRENCY;
+    /// @brief Split the workers into per-NUMA-node groups. Each worker is pinned to the CPUs
+    /// of its node and prefers its node for BUFFER_CREATE_NUMA_LOCAL buffers, so tiles decoded
+    /// within a task reside on the socket that decoded them. Consumers of those tiles may be
+    /// issued to the same node with __INTERNAL__Pool::issue_task_on_node. No effect on
+    /// single-node systems.
+    bool                            numaNodeGroups  = false;
+    /// @brief Give each worker its own task deque. Tasks issued from within a worker are
+    /// pushed to and popped from that worker's deque (LIFO) and idle workers steal from
+    /// the opposite end of a random victim's deque (FIFO). Tasks issued from outside the
+    /// pool, and interactive or background tasks, are injected through the shared lanes.
+    /// Reduces contention on the shared queue when tasks spawn further tasks, such as
+    /// tile decodes issued by a region task.
+    bool                            workStealing    = false;
+    /// @brief Prefix of the worker thread names ("<name>-<index>", shown by top, perf and
+    /// debuggers). Truncated to the 15 characters permitted by the system. Empty leaves
+    /// the workers unnamed.
+    std::string                     name            = "iris-worker";
+    /// @brief CPUs each worker may run on; worker i uses entry i modulo the number of entries.
+    /// Provide one single-CPU entry per worker to pin workers one-to-one, or a single shared
+    /// entry to confine the pool to a set of cores. Takes precedence over NUMA node pinning
+    /// (the worker's node preference for buffer allocation still applies). Empty sets, and
+    /// CPUs outside of the process affinity mask, are ignored.
+    /// \note To reserve cores for I/O workers versus decode workers, create a pool per role
+    /// with disjoint CPU sets (ex: split getAvailableCpus()).
+    std::vector<CpuSet>             workerCpuSets   {};
+    /// @brief Scheduling niceness of the workers (-20 to 19, where higher yields the CPU more
+    /// readily). Use a positive value for background pools, such as an encoder, so they do
+    /// not compete with request threads. Lowering the niceness requires privileges.
+    int                             niceness        = 0;
+    /// @brief Time the execution of every task, for the run latency histograms and the
+    /// worker busy time of get_statistics(). Costs one clock read per task. Wake latency,
+    /// task, steal and park counts are always collected.
+    bool                            instrumentation = false;
+    /// @brief Grow and shrink the pool with load. The pool starts minimumThreads workers and
+    /// spawns more, up to threads, whenever tasks are queued and no worker is idle (including
+    /// when workers are blocked; see __INTERNAL__Pool::begin_blocking). Workers above the
+    /// minimum retire after idleTimeout without work. Lets one pool be shared across slides
+    /// and encoders without holding idle threads.
+    bool                            elastic         = false;
+    /// @brief Workers kept alive by an elastic pool (at least 1)
+    uint32_t                        minimumThreads  = 1;
+    /// @brief Time an elastic pool's worker may go without work before retiring
+    std::chrono::milliseconds       idleTimeout     {5000};
+};
 
 ThreadPool createThreadPool (uint32_t thread_pool_size = IRIS_CONCURRENCY);
+ThreadPool createThreadPool (const ThreadPoolCreateInfo&);
+/**
+ * @brief CPUs the calling process is permitted to run on, in ascending order.
+ * 
+ * Used to divide the available cores between pools (see ThreadPoolCreateInfo::workerCpuSets).
+ * Returns an empty set if the platform does not expose CPU affinity.
+ */
+CpuSet getAvailableCpus ();
+/**
+ * @brief Create a cancellation token to group pool tasks.
+ * 
+ * Issue any number of tasks with the token; cancelling the token withdraws
+ * every one of them that has not yet started (ex: decodes of tiles that have
+ * scrolled off-screen). Long running tasks may also poll the token.
+ */
+CancelToken createCancelToken ();
+/**
+ * @brief Create an unsignalled fence (signal it with __INTERNAL__Fence::signal).
+ * 
+ * Fences are allocated from a per-thread pool of recycled fences; the fences of
+ * pool tasks are allocated the same way.
+ */
+Fence createFence ();
+/**
+ * @brief Create a fence that is signalled once every one of the given fences is signalled.
+ * 
+ * No thread waits for the fences; the returned fence is signalled by whichever
+ * thread signals the last of them. Null fences are treated as already signalled.
+ */
+Fence createJoinFence (const std::vector<Fence>& fences);
+
+using TimePoint     = std::chrono::steady_clock::time_point;
+/**
+ * @brief Wait until every fence is signalled or the deadline passes.
+ * 
+ * All of the fences are waited upon at once: the calling thread sleeps on one
+ * shared event count that is notified as any fence is signalled, rather than
+ * waiting on each fence in turn. Null fences are treated as already signalled.
+ * 
+ * @return true if every fence was signalled before the deadline
+ */
+bool wait_all (const std::vector<Fence>& fences, TimePoint deadline = TimePoint::max());
+/**
+ * @brief Wait until any fence is signalled or the deadline passes.
+ * 
+ * Use with a frame deadline to render whatever tiles have arrived in time,
+ * removing (or nulling) each fence as its tile is drawn.
+ * 
+ * @return index of a signalled fence (the lowest), or fences.size() if none
+ * was signalled before the deadline
+ */
+size_t wait_any (const std::vector<Fence>& fences, TimePoint deadline = TimePoint::max());
+
+/**
+ * @brief Scheduling class of a pool task.
+ * 
+ * Workers always drain the higher classes first. To guard the background
+ * class against starvation, every IRIS_ASYNC_STARVATION_INTERVAL-th task
+ * selection made by a worker checks the background lane first.
+ */
+enum TaskPriority : uint8_t {
+    /// @brief Latency critical work, such as decoding tiles in the visible viewport
+    TASK_PRIORITY_INTERACTIVE   = 0,
+    /// @brief Default class
+    TASK_PRIORITY_NORMAL        = 1,
+    /// @brief Throughput work, such as speculative prefetch and slide encoding
+    TASK_PRIORITY_BACKGROUND    = 2,
+    TASK_PRIORITY_MAX_ENUM,
+};
+
+/**
+ * @brief Move-only void() callable that stores small captured state inline.
+ *
+ * Callables of up to IRIS_INLINE_LAMBDA_SIZE bytes (ex: a lambda capturing a
+ * few pointers, handles and indices) are stored within the object itself, so
+ * issuing them as pool tasks does not allocate. Larger callables, and those
+ * that may throw when moved, are stored on the heap. Unlike LambdaPtr, the
+ * callable need not be copyable (ex: it may capture a std::unique_ptr).
+ */
+class InlineLambda {
+public:
+    InlineLambda                    () noexcept = default;
+    InlineLambda                    (std::nullptr_t) noexcept { }
+    template <class Function, class = std::enable_if_t<
+    !std::is_same_v<std::decay_t<Function>, InlineLambda> &&
+    std::is_invocable_r_v<void, std::decay_t<Function>&>>>
+    InlineLambda                    (Function&& function) {
+        using Callable = std::decay_t<Function>;
+        if constexpr (std::is_constructible_v<bool, const Callable&>)
+            if (!static_cast<bool>(function)) return;   // Empty LambdaPtr
+        if constexpr (IS_INLINE<Callable>) {
+            new (_storage) Callable (std::forward<Function>(function));
+            _operations = &INLINE_OPERATIONS<Callable>;
+        } else {
+            *reinterpret_cast<Callable**>(_storage) = new Callable (std::forward<Function>(function));
+            _operations = &HEAP_OPERATIONS<Callable>;
+        }
+    }
+    InlineLambda                    (InlineLambda&& other) noexcept :
+    _operations                     (other._operations) {
+        if (_operations) _operations->relocate(_storage, other._storage);
+        other._operations = nullptr;
+    }
+    InlineLambda& operator =        (InlineLambda&& other) noexcept {
+        if (this != &other) {
+            reset();
+            _operations = other._operations;
+            if (_operations) _operations->relocate(_storage, other._storage);
+            other._operations = nullptr;
+        }   return *this;
+    }
+    InlineLambda& operator =        (std::nullptr_t) noexcept { reset(); return *this; }
+    InlineLambda                    (const InlineLambda&) = delete;
+    InlineLambda& operator =        (const InlineLambda&) = delete;
+   ~InlineLambda                    () { reset(); }
+    void operator ()                () { _operations->invoke(_storage); }
+    explicit operator bool          () const noexcept { return _operations != nullptr; }
+private:
+    struct Operations {
+        void (*invoke)              (void*);
+        void (*relocate)            (void* destination, void* source) noexcept;
+        void (*destroy)             (void*) noexcept;
+    };
+    template <class Callable>
+    static constexpr bool IS_INLINE =
+    sizeof(Callable) <= IRIS_INLINE_LAMBDA_SIZE &&
+    alignof(Callable) <= alignof(std::max_align_t) &&
+    std::is_nothrow_move_constructible_v<Callable>;
+    template <class Callable>
+    static constexpr Operations INLINE_OPERATIONS {
+        [](void* storage) { (*static_cast<Callable*>(storage))(); },
+        [](void* destination, void* source) noexcept {
+            new (destination) Callable (std::move(*static_cast<Callable*>(source)));
+            static_cast<Callable*>(source)->~Callable();
+        },
+        [](void* storage) noexcept { static_cast<Callable*>(storage)->~Callable(); },
+    };
+    template <class Callable>
+    static constexpr Operations HEAP_OPERATIONS {
+        [](void* storage) { (**static_cast<Callable**>(storage))(); },
+        [](void* destination, void* source) noexcept {
+            *static_cast<Callable**>(destination) = *static_cast<Callable**>(source);
+        },
+        [](void* storage) noexcept { delete *static_cast<Callable**>(storage); },
+    };
+    void reset                      () noexcept {
+        if (_operations) _operations->destroy(_storage);
+        _operations = nullptr;
+    }
+    alignas(std::max_align_t) unsigned char _storage [IRIS_INLINE_LAMBDA_SIZE];
+    const Operations*               _operations     = nullptr;
+};
+
+/**
+ * @brief Allocator that recycles freed blocks through per-thread free lists.
+ *
+ * Used with std::allocate_shared so that the control block and object of
+ * short-lived shared state, such as fences, are reused rather than returned
+ * to the heap. Each thread caches up to IRIS_ASYNC_RECYCLED_BLOCKS blocks of
+ * each type. As blocks are often freed by a different thread than the one that
+ * allocated them (ex: a fence released by the worker that signalled it), a full
+ * cache passes half of its blocks to a shared depot, from which an empty cache
+ * refills, one lock per batch. Blocks beyond the depot's capacity are freed.
+ */
+template <class T>
+struct __INTERNAL__RecyclingAllocator {
+    using value_type = T;
+    __INTERNAL__RecyclingAllocator  () noexcept = default;
+    template <class U>
+    __INTERNAL__RecyclingAllocator  (const __INTERNAL__RecyclingAllocator<U>&) noexcept { }
+    T* allocate (size_t count) {
+        auto& cache = CACHE();
+        if (count == 1 && (cache.head || REFILL(cache))) {
+            auto block  = cache.head;
+            cache.head  = block->next;
+            cache.count--;
+            return reinterpret_cast<T*>(block);
+        }   return static_cast<T*>(::operator new (count * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    void deallocate (T* pointer, size_t count) noexcept {
+        if (count != 1) return FREE(pointer);
+        auto& cache = CACHE();
+        if (cache.count >= IRIS_ASYNC_RECYCLED_BLOCKS) SPILL(cache);
+        auto block  = reinterpret_cast<__Block*>(pointer);
+        block->next = cache.head;
+        cache.head  = block;
+        cache.count++;
+    }
+    template <class U>
+    bool operator == (const __INTERNAL__RecyclingAllocator<U>&) const noexcept { return true; }
+private:
+    struct __Block { __Block* next; };
+    static_assert(sizeof(T) >= sizeof(__Block), "Recycled blocks must be able to hold a link");
+    struct __Cache {
+        __Block*                    head            = nullptr;
+        uint32_t                    count           = 0;
+       ~__Cache                     () { while (head) FREE(std::exchange(head, head->next)); }
+    };
+    struct __Depot : public __Cache {
+        Mutex                       lock;
+    };
+    static constexpr uint32_t BATCH = IRIS_ASYNC_RECYCLED_BLOCKS / 2 ? IRIS_ASYNC_RECYCLED_BLOCKS / 2 : 1;
+    static void FREE (void* block) noexcept {
+        ::operator delete (block, std::align_val_t(alignof(T)));
+    }
+    static __Cache& CACHE () {
+        thread_local __Cache cache;
+        return cache;
+    }
+    static __Depot& DEPOT () {
+        static __Depot& depot = *new __Depot;   // Never destroyed; blocks may be freed during exit
+        return depot;
+    }
+    // Move up to a batch of blocks from the source list to the destination list.
+    static void TRANSFER (__Cache& source, __Cache& destination) noexcept {
+        for (uint32_t moved = 0; moved < BATCH && source.head; ++moved) {
+            auto block          = source.head;
+            source.head         = block->next;
+            block->next         = destination.head;
+            destination.head    = block;
+            source.count--;
+            destination.count++;
+        }
+    }
+    static bool REFILL (__Cache& cache) {
+        auto& depot = DEPOT();
+        MutexLock depot_lock (depot.lock);
+        TRANSFER(depot, cache);
+        return cache.head != nullptr;
+    }
+    static void SPILL (__Cache& cache) noexcept {
+        auto& depot = DEPOT();
+        {   MutexLock depot_lock (depot.lock);
+            if (depot.count < IRIS_ASYNC_RECYCLED_BLOCKS * 16U)
+                return TRANSFER(cache, depot);
+        }   while (cache.count > IRIS_ASYNC_RECYCLED_BLOCKS - BATCH) {
+            FREE(std::exchange(cache.head, cache.head->next));
+            cache.count--;
+        }
+    }
+};
 
 struct Callback {
-    LambdaPtr                       callback        = nullptr;
+    InlineLambda                    callback        = nullptr;
     Fence                           fenceOptional   = nullptr;
+    CancelToken                     cancelOptional  = nullptr;
+    TimePoint                       issued          = {};
+    TaskPriority                    priority        = TASK_PRIORITY_NORMAL;
+};
+
+/**
+ * @brief Histogram of latencies in nanoseconds with log-linear (HDR style) buckets.
+ * 
+ * Each power-of-two range of latencies is divided into 2^IRIS_LATENCY_PRECISION_BITS
+ * equal buckets, so any latency is resolved to within 12.5% by default while latencies
+ * up to 2^IRIS_LATENCY_RANGE_BITS ns (about 18 minutes) fit in a few hundred counters.
+ * Latencies below 2^IRIS_LATENCY_PRECISION_BITS ns are counted exactly. The final
+ * bucket also counts any longer latency.
+ */
+struct LatencyHistogram {
+    uint64_t                        buckets [IRIS_LATENCY_BUCKETS] = {};
+    uint64_t                        samples         = 0;
+    /**
+     * @brief Upper bound (in ns) of the bucket that contains the given quantile.
+     * 
+     * @param quantile fraction of samples in [0.0, 1.0] (ex: 0.99 for the p99 latency)
+     */
+    uint64_t quantile               (double quantile) const;
+    /// @brief Add the samples of another histogram into this one.
+    void merge                      (const LatencyHistogram&);
+    /// @brief Bucket that counts the given latency in nanoseconds.
+    static uint32_t bucket          (uint64_t nanoseconds);
+    /// @brief Exclusive upper bound (in ns) of the latencies counted by a bucket.
+    static uint64_t upper_bound     (uint32_t bucket);
+};
+
+/**
+ * @brief Activity of a single pool worker (see __INTERNAL__Pool::get_statistics).
+ */
+struct WorkerStatistics {
+    /// @brief Tasks started by the worker (including cancelled tasks it skipped)
+    uint64_t                        tasks           = 0;
+    /// @brief Tasks taken from another worker's deque (work-stealing pools)
+    uint64_t                        steals          = 0;
+    /// @brief Times the worker found no work and went to sleep
+    uint64_t                        parks           = 0;
+    /// @brief Time spent executing tasks (instrumented pools only)
+    uint64_t                        busyNanoseconds = 0;
+    /// @brief Time the worker thread has been running
+    uint64_t                        aliveNanoseconds= 0;
+    /// @brief Fraction of the worker's lifetime spent executing tasks (instrumented pools only)
+    double busy_ratio               () const;
+};
+
+/**
+ * @brief Point-in-time snapshot of the activity of a pool.
+ * 
+ * Counters are cumulative since the pool was created; subtract two snapshots
+ * to find the activity within an interval. Fields are sampled independently
+ * without stopping the pool, so they are not mutually consistent to the task.
+ */
+struct PoolStatistics {
+    /// @brief Tasks issued but not yet complete (queued or running); the queue depth
+    size_t                          pendingTasks    = 0;
+    /// @brief Tasks skipped because their cancellation token was cancelled
+    size_t                          cancelledTasks  = 0;
+    /// @brief Whether run latencies and busy time were collected (see instrumentation)
+    bool                            instrumented    = false;
+    /// @brief Time between issuing a task and a worker starting it, per priority
+    LatencyHistogram                waitLatency     [TASK_PRIORITY_MAX_ENUM];
+    /// @brief Time between a worker starting a task and finishing it, per priority
+    LatencyHistogram                runLatency      [TASK_PRIORITY_MAX_ENUM];
+    std::vector<WorkerStatistics>   workers;
+};
+
+/// Counters owned and written only by a single worker. Sampled into WorkerStatistics.
+struct alignas(64) __INTERNAL__WorkerStatistics {
+    atomic_uint64                   tasks           {0};
+    atomic_uint64                   steals          {0};
+    atomic_uint64                   parks           {0};
+    atomic_uint64                   busy            {0};    // ns
+    atomic_uint64                   alive           {0};    // ns, of previous runs of the worker
+    atomic_sint64                   started         {0};    // ns since epoch, 0 when stopped
+    
+    /// Single-writer increment, cheaper than an atomic read-modify-write.
+    static void add                 (atomic_uint64& counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+    void sample_into                (WorkerStatistics&) const;
+};
+
+/// Lock-free latency accumulator. Sampled into a LatencyHistogram.
+struct alignas(64) __INTERNAL__LatencyHistogram {
+    atomic_uint64                   buckets [IRIS_LATENCY_BUCKETS] = {};
+    
+    void record                     (std::chrono::nanoseconds latency);
+    void sample_into                (LatencyHistogram&) const;
+};
+
+/**
+ * @brief Event count used to park idle threads without missing a wake-up.
+ * 
+ * A waiter takes a key with prepare_wait(), re-checks its wake condition, and
+ * then either calls cancel_wait() or wait(key). Any notification issued after
+ * prepare_wait() advances the epoch so wait(key) returns immediately rather than
+ * sleeping through it. Notifications are free when there are no waiters.
+ */
+class __INTERNAL__EventCount {
+    atomic_uint32                   _epoch          {0};
+    atomic_uint32                   _waiters        {0};
+    Mutex                           _mtx;
+    Notification                    _cv;
+public:
+    uint32_t prepare_wait           ();
+    void    cancel_wait             ();
+    void    wait                    (uint32_t key);
+    /// @brief As wait, but gives up after the timeout. Returns false if it timed out.
+    bool    wait_for                (uint32_t key, std::chrono::nanoseconds timeout);
+    void    notify_one              ();
+    void    notify_many             (size_t count);
+    void    notify_all              ();
+};
+
+/**
+ * @brief Per-worker task deque used by work-stealing pools.
+ * 
+ * The owning worker pushes and pops at the back; thieves take from the front.
+ * The lock is only contended when the deque is stolen from.
+ */
+struct __INTERNAL__WorkerQueue {
+    Mutex                           lock;
+    std::deque<Callback>            tasks;
+    
+    void push                       (Callback&&);
+    bool pop_back                   (Callback&);
+    bool pop_front                  (Callback&);
+    bool steal_front                (Callback&);
+};
+
+/**
+ * @brief Tasks issued to the workers of one NUMA node group (see issue_task_on_node).
+ */
+struct __INTERNAL__NodeQueue {
+    __INTERNAL__WorkerQueue         tasks;
+    atomic_uint32                   queued          {0};    // Tasks in the queue
+    atomic_uint32                   parked          {0};    // Workers of the group parked
+    uint32_t                        workers         = 0;    // Workers in the group
+};
+
+/**
+ * @brief Hashed timing wheel holding the delayed tasks of a pool.
+ * 
+ * Time is divided into ticks of IRIS_ASYNC_TIMER_RESOLUTION_US and each timer is
+ * hashed into the slot of its deadline tick (modulo IRIS_ASYNC_TIMER_SLOTS). Timers
+ * more than one revolution away share slots with nearer ones until their tick is
+ * reached. Adding a timer is constant time; advancing visits the slots of the
+ * elapsed ticks only.
+ */
+struct __INTERNAL__TimerWheel {
+    struct Timer {
+        uint64_t                    tick;           // Deadline, in ticks since the epoch
+        Callback                    task;
+    };
+    Mutex                           lock;
+    std::vector<Timer>              slots [IRIS_ASYNC_TIMER_SLOTS];
+    const TimePoint                 epoch           = std::chrono::steady_clock::now();
+    uint64_t                        current         = 0;            // Last tick advanced through
+    size_t                          count           = 0;
+    atomic_uint64                   next            {UINT64_MAX};   // Earliest tick set, if any
+    atomic_bool                     keeper          {false};        // A parked worker keeps time
+    
+    /// @brief Add a timer. Returns true if it is now the earliest timer.
+    bool add                        (TimePoint deadline, Callback&&);
+    /// @brief Remove every timer due by now, appending its task to expired.
+    void advance                    (TimePoint now, std::vector<Callback>& expired);
+    void clear                      ();
+    uint64_t tick                   (TimePoint) const;
+    TimePoint deadline              (uint64_t tick) const;
 };
 
 struct __INTERNAL__Fence {
     atomic_bool                     complete;
+    atomic_bool                     cancelled;      // Task was withdrawn and did not run
+    atomic_size                     outstanding;    // Tasks yet to arrive (aggregate fences)
+    Mutex                           continuationLock;
+    LambdaPtrs                      continuations;  // Invoked once when signalled
     
     explicit __INTERNAL__Fence      () :
-    complete                        (false) { }
+    complete                        (false),
+    cancelled                       (false),
+    outstanding                     (1) { }
     __INTERNAL__Fence               (const __INTERNAL__Fence&) = delete;
     __INTERNAL__Fence& operator =   (const __INTERNAL__Fence&) = delete;
     void wait_on_signal ();
+    /// @brief Wait until the fence is signalled or the deadline passes; true if signalled.
+    bool wait_until (TimePoint deadline);
+    void signal ();
+    /// @brief Mark one of the fence's outstanding tasks complete; the last signals the fence.
+    void arrive ();
+    /**
+     * @brief Register a callback to be invoked by the thread that signals the fence.
+     * 
+     * Continuations should be brief (such as issuing a task) as they run on the
+     * signalling thread.
+     * 
+     * @return false if the fence was already signalled; the callback is not retained
+     * and the caller should invoke it directly.
+     */
+    bool add_continuation (const LambdaPtr&);
+};
+
+/**
+ * @brief Builder for a directed acyclic graph of pool tasks submitted as a unit.
+ * 
+ * Tasks may only depend upon tasks previously added to the graph, which keeps the
+ * graph acyclic by construction. Once submitted (see __INTERNAL__Pool::issue_task_graph),
+ * each task is issued by the thread completing its final dependency; no thread blocks.
+ * The builder may be reused or submitted more than once.
+ */
+class TaskGraph {
+public:
+    using Node = uint32_t;
+    struct __Task {
+        LambdaPtr                   task;
+        TaskPriority                priority;
+        std::vector<Node>           dependencies;
+    };
+    /**
+     * @brief Add a task that runs once all of its dependencies have completed.
+     * 
+     * @param task lambda to invoke
+     * @param dependencies nodes previously returned by add_task
+     * @param priority scheduling class of the task
+     * @return Node handle used to declare dependencies upon this task
+     */
+    Node    add_task                (const LambdaPtr& task,
+                                     std::initializer_list<Node> dependencies = {},
+                                     TaskPriority priority = TASK_PRIORITY_NORMAL);
+    /// @brief Declare that @ref after may only start once @ref before completes (before < after).
+    void    add_dependency          (Node before, Node after);
+    size_t  size                    () const;
+    const std::vector<__Task>& tasks () const;
+private:
+    std::vector<__Task>             _tasks;
+};
+
+/**
+ * @brief Cooperative cancellation shared by a group of pool tasks.
+ * 
+ * Queued tasks issued with a cancelled token are skipped without invoking their
+ * lambda; their fences are still signalled (with the fence cancelled flag set).
+ * Cancellation does not interrupt a running task, but the task may poll
+ * is_cancelled() to return early.
+ */
+struct __INTERNAL__CancelToken {
+    atomic_bool                     cancelled       {false};
+    
+    void cancel                     () { cancelled.store(true, std::memory_order_release); }
+    bool is_cancelled               () const { return cancelled.load(std::memory_order_acquire); }
 };
 
 enum __status : uint8_t {
@@ -43,29 +607,615 @@ enum __status : uint8_t {
 };
 using Status = std::atomic<__status>;
 
+template <class T> class Future;
+
+/**
+ * @brief Scheduling state owned by a single pool worker.
+ */
+struct __INTERNAL__WorkerState {
+    uint32_t                        index;
+    FIFO2::Iterator<Callback>       lanes [TASK_PRIORITY_MAX_ENUM];
+    uint32_t                        selections      = 0;
+    Mutex                           lanesLock       {};     // Held to advance the lanes (elastic pools)
+};
+
+/**
+ * @brief Link from deferred tasks (see issue_task_after) back to their pool.
+ * 
+ * Continuations hold the link rather than the pool, which may be destroyed before
+ * their predecessors are signalled. The pool clears the link once its workers exit;
+ * tasks released after that are withdrawn and their fences signalled as cancelled.
+ */
+struct __INTERNAL__PoolLink {
+    Mutex                           lock;
+    class __INTERNAL__Pool*         pool            = nullptr;
+};
+
 class __INTERNAL__Pool {
-    TaskList        _tasks;
+    const ThreadPoolCreateInfo      _info;
+    TaskList        _tasks [TASK_PRIORITY_MAX_ENUM]; // One lane per priority
     Threads         _threads;
-    Mutex           _task_added_mtx; // Used only for conditional variable
-    Notification    _task_added;     // Conditional variable notification
+    std::vector<std::unique_ptr<__INTERNAL__WorkerState>> _states; // Scheduling state of each running worker
+    std::vector<uint16_t>           _nodes;          // NUMA node of each worker
+    std::vector<std::unique_ptr<__INTERNAL__WorkerQueue>> _locals; // Work-stealing deques
+    std::vector<std::unique_ptr<__INTERNAL__NodeQueue>> _node_queues; // Node-affine tasks (grouped pools)
+    std::vector<std::unique_ptr<__INTERNAL__LatencyHistogram>> _latency; // Issue to start latency per worker and priority
+    std::vector<std::unique_ptr<__INTERNAL__LatencyHistogram>> _runtime; // Start to finish latency per worker and priority
+    std::vector<std::unique_ptr<__INTERNAL__WorkerStatistics>> _statistics; // Per worker counters
+    __INTERNAL__EventCount          _idle;           // Parking for idle workers
+    __INTERNAL__TimerWheel          _timers;         // Delayed and periodic tasks
+    Mutex                           _elastic;        // Serializes worker spawn and retirement
+    std::vector<uint8_t>            _live;           // Slots with a running worker (elastic)
+    atomic_uint32                   _workers;        // Running workers
+    atomic_uint32                   _blocked;        // Workers blocked within a task
+    std::shared_ptr<__INTERNAL__PoolLink> _link;     // Shared with deferred tasks
+    atomic_size                     _deferred;       // Pending tasks awaiting their predecessors
     atomic_size     _pending;
+    atomic_size     _cancelled;
     Status          status;
     
 public:
     explicit __INTERNAL__Pool       (uint32_t thread_pool_size);
+    explicit __INTERNAL__Pool       (const ThreadPoolCreateInfo&);
     __INTERNAL__Pool                (const __INTERNAL__Pool&) = delete;
     __INTERNAL__Pool& operator =    (const __INTERNAL__Pool&) = delete;
    ~__INTERNAL__Pool                ();
     size_t  pending_tasks           () const;
-    void    issue_task              (const LambdaPtr&);
-    Fence   issue_task_with_fence   (const LambdaPtr&);
+    /// @brief Number of worker threads in the pool (the maximum number, if elastic).
+    uint32_t thread_count           () const;
+    /// @brief Number of worker threads currently running.
+    uint32_t active_threads         () const;
+    /**
+     * @brief Declare that the calling task is about to block, such as on file or network I/O.
+     * 
+     * Elastic pools spawn another worker (up to the maximum) if tasks are queued and
+     * no worker is free to take them, so blocked workers do not stall decode work.
+     * Every call must be paired with end_blocking(). No effect on fixed size pools.
+     */
+    void    begin_blocking          ();
+    /// @brief Declare that the calling task has stopped blocking (see begin_blocking).
+    void    end_blocking            ();
+    /// @brief NUMA node of a worker's group, or IRIS_NUMA_NODE_ANY if workers are not grouped.
+    uint16_t worker_numa_node       (uint32_t worker_index) const;
+    /**
+     * @brief Sample the wake latency histogram of the pool.
+     * 
+     * The wake latency is the time between a task being issued and a worker starting it.
+     * This includes both time spent queued behind other tasks and the time taken to wake
+     * a parked worker. An idle pool should start tasks within microseconds.
+     */
+    LatencyHistogram get_wake_latency_histogram () const;
+    /// @brief Sample the wake latency histogram of tasks issued with the given priority.
+    LatencyHistogram get_wake_latency_histogram (TaskPriority) const;
+    /// @brief Number of tasks skipped because their cancellation token was cancelled.
+    size_t  cancelled_tasks         () const;
+    /**
+     * @brief Sample the pool's instrumentation without pausing it.
+     * 
+     * Use the busy ratios and wait latencies to size the pool: workers that are
+     * rarely idle while wait latency grows indicate too few threads, and many
+     * parks with low busy ratios indicate too many. A run latency tail flags
+     * stalled tasks, such as slow decodes.
+     */
+    PoolStatistics get_statistics   () const;
+    /**
+     * @brief Issue a task to the pool.
+     * 
+     * Tasks whose captured state fits within an InlineLambda are issued without
+     * allocating; pass a lambda directly rather than through a LambdaPtr.
+     * 
+     * @return false if the pool is shutting down and the task was not issued
+     */
+    bool    issue_task              (InlineLambda, TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    Fence   issue_task_with_fence   (InlineLambda, TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    /**
+     * @brief Issue a task to the workers of one NUMA node group, such as the consumer
+     * of a tile decoded into a BUFFER_CREATE_NUMA_LOCAL buffer on that node.
+     * 
+     * Only workers of the node's group run the task; they serve node tasks after the
+     * interactive lane and ahead of the normal and background lanes. Pools without
+     * node groups (see ThreadPoolCreateInfo::numaNodeGroups), elastic pools, and nodes
+     * without workers issue the task to the pool as a whole.
+     * 
+     * @return Fence signalled when the task completes
+     */
+    Fence   issue_task_on_node      (uint16_t numa_node, InlineLambda,
+                                     const CancelToken& = nullptr);
+    /**
+     * @brief Issue a task that returns a value, such as a decoded tile Buffer.
+     * 
+     * The future receives the value returned by the function or the exception it
+     * threw, so pipelines need no side-channel state to collect results or errors.
+     * \note Tasks issued to an inactive pool return a future carrying a runtime_error.
+     */
+    template <class Function>
+    auto    submit                  (Function, TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr)
+    -> Future<std::invoke_result_t<Function&>>;
+    /**
+     * @brief Issue a batch of tasks, such as every tile of a layer, in one submission.
+     * 
+     * Queue entries are reserved in contiguous runs, the pending count is raised
+     * once, and only as many idle workers as there are tasks are woken, in one step.
+     */
+    void    issue_tasks             (std::span<const LambdaPtr>, TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    /**
+     * @brief Issue a batch of tasks (see issue_tasks) sharing one aggregate fence.
+     * 
+     * @return Fence signalled once every task in the batch has completed
+     */
+    Fence   issue_tasks_with_fence  (std::span<const LambdaPtr>, TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    /**
+     * @brief Issue a task once all of its predecessor fences have been signalled.
+     * 
+     * The task is queued by the thread that signals the final predecessor, so no
+     * thread is parked waiting on the predecessors. It counts as pending from the
+     * time it is issued. Cancelled predecessors count as signalled; share a cancel
+     * token between the stages of a pipeline to withdraw the later stages as well.
+     * 
+     * Draining the pool waits for deferred tasks released by its own tasks. A task
+     * whose predecessors are signalled only once the pool has drained, terminated or
+     * been destroyed is withdrawn; its fence is signalled with the cancelled flag set.
+     * 
+     * @return Fence signalled when the task completes
+     */
+    Fence   issue_task_after        (const std::vector<Fence>& predecessors, InlineLambda,
+                                     TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    /**
+     * @brief Submit every task of a task graph, honouring its dependencies.
+     * 
+     * @return Fence signalled when every task in the graph has completed
+     */
+    Fence   issue_task_graph        (const TaskGraph&, const CancelToken& = nullptr);
+    /**
+     * @brief Issue a task once a delay has elapsed, such as a prefetch that should only
+     * run if the viewport is still stable 50 ms later.
+     * 
+     * Timers are kept by the pool's own workers rather than a timer thread. While
+     * workers are parked, one of them sleeps until the earliest deadline; while all are
+     * busy, they fire due timers between tasks. Tasks never start early but may start up
+     * to IRIS_ASYNC_TIMER_RESOLUTION_US late, or later if every worker is occupied.
+     * \note Timers yet to fire when the pool drains or terminates are discarded.
+     * 
+     * @return Token that withdraws the task when cancelled (the given token, if any)
+     */
+    CancelToken schedule_after      (std::chrono::nanoseconds delay, InlineLambda,
+                                     TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    /**
+     * @brief Issue a task every period, such as periodic cache trimming.
+     * 
+     * Each run is scheduled one period after the previous run was due, once that run
+     * has returned, so runs never overlap and an overrun is not followed by a burst of
+     * missed runs. A run that throws ends the schedule.
+     * 
+     * @return Token that stops the schedule when cancelled (the given token, if any)
+     */
+    CancelToken schedule_every      (std::chrono::nanoseconds period, LambdaPtr,
+                                     TaskPriority = TASK_PRIORITY_NORMAL,
+                                     const CancelToken& = nullptr);
+    /// @brief Awaitable returned by schedule(). Resumes the awaiting coroutine as a pool task.
+    struct ScheduleAwaiter {
+        __INTERNAL__Pool*           pool;
+        TaskPriority                priority;
+        bool await_ready            () const noexcept { return false; }
+        bool await_suspend          (std::coroutine_handle<>);
+        void await_resume           () const noexcept { }
+    };
+    /**
+     * @brief Move the awaiting coroutine onto a pool worker: `co_await pool->schedule();`
+     * 
+     * The coroutine is resumed as a task of the given priority. If the pool is shutting
+     * down, the coroutine continues on the awaiting thread instead.
+     */
+    ScheduleAwaiter schedule        (TaskPriority = TASK_PRIORITY_NORMAL);
     void    wait_until_complete     ();
     void    terminate               ();
     void    reset                   ();
 private:
-    void    process_tasks           ();
+    template <class> friend class Future;
+    bool    issue_with_fence        (InlineLambda&&, const Fence&, TaskPriority, const CancelToken&);
+    bool    issue_after             (const std::vector<Fence>& predecessors, InlineLambda&&,
+                                     const Fence&, TaskPriority, const CancelToken&);
+    void    add_timer               (TimePoint deadline, Callback&&);
+    void    fire_timers             ();
+    void    schedule_periodic       (TimePoint deadline, std::chrono::nanoseconds period,
+                                     LambdaPtr, TaskPriority, const CancelToken&);
+    void    start_worker            (uint32_t worker_index);
+    void    start_workers           (uint32_t count);
+    void    grow                    ();
+    size_t  runnable_tasks          () const;
+    bool    retire                  (__INTERNAL__WorkerState&);
+    void    unlink                  ();
+    bool    awaiting_deferred       () const;
+    void    process_tasks           (__INTERNAL__WorkerState&);
+    void    push_task               (Callback&&);
+    void    issue_batch             (std::span<const LambdaPtr>, TaskPriority,
+                                     const CancelToken&, const Fence&);
+    void    push_tasks              (std::vector<Callback>&);
+    bool    next_task               (__INTERNAL__WorkerState&, Callback&);
+    bool    pop_lane                (__INTERNAL__WorkerState&, TaskPriority, Callback&);
+    bool    wait_for_task           (__INTERNAL__WorkerState&, Callback&);
+    void    execute_task            (__INTERNAL__WorkerState&, Callback&);
+};
+
+// MARK: - PARALLEL ALGORITHMS
+using TileFunction      = std::function<void(TileIndex tile)>;
+using TileFunction2D    = std::function<void(uint32_t x_tile, uint32_t y_tile)>;
+using ChunkFunction     = std::function<void(uint32_t slot, TileIndex first, TileIndex last)>;
+/**
+ * @brief Invoke a function on every contiguous chunk of [begin, end) using the
+ * calling thread and up to every worker of the pool.
+ * 
+ * Chunks are claimed dynamically and shrink as the range is consumed (guided
+ * scheduling): each claim takes the larger of the grain and an even share of what
+ * remains. The calling thread claims chunks too and, once none remain, waits only
+ * for chunks already in flight. Pool helpers that start after the range has been
+ * consumed return immediately. The slot identifies the participant (0 is the
+ * caller) and is below thread_count() + 1, for per-participant accumulation.
+ * The first exception thrown by the function is rethrown on the calling thread.
+ * 
+ * \note Safe to call from within a pool task (the caller always makes progress).
+ */
+void __INTERNAL__parallel_chunks    (const ThreadPool&, TileIndex begin, TileIndex end,
+                                     TileIndex grain, const ChunkFunction&,
+                                     TaskPriority = TASK_PRIORITY_NORMAL);
+/**
+ * @brief Invoke a function on every tile index in [begin, end) in parallel.
+ * 
+ * Blocks until every tile has been processed. See __INTERNAL__parallel_chunks for scheduling.
+ * 
+ * @param grain minimum number of tiles claimed at a time (use larger values for cheaper functions)
+ */
+void parallel_for                   (const ThreadPool&, TileIndex begin, TileIndex end,
+                                     TileIndex grain, const TileFunction&,
+                                     TaskPriority = TASK_PRIORITY_NORMAL);
+/**
+ * @brief Invoke a function on every (x, y) tile of a layer in parallel.
+ * 
+ * Tiles are visited in row-major order (index = y * xTiles + x) so that
+ * chunks cover horizontally adjacent tiles.
+ */
+void parallel_for_2d                (const ThreadPool&, const LayerExtent&,
+                                     TileIndex grain, const TileFunction2D&,
+                                     TaskPriority = TASK_PRIORITY_NORMAL);
+/**
+ * @brief Reduce every tile index in [begin, end) to a single value in parallel.
+ * 
+ * Each participating thread folds its chunks into its own partial result starting
+ * from the identity; the partials are then combined on the calling thread.
+ * \note Partials are combined in participant order, not index order. The combine
+ * function must be associative and commutative (beware floating point sums).
+ * 
+ * @param identity initial value of every partial result
+ * @param accumulate returns the partial result with one tile folded in
+ * @param combine returns the combination of two partial results
+ */
+template <class T, class Accumulate, class Combine>
+T parallel_reduce (const ThreadPool& pool, TileIndex begin, TileIndex end, TileIndex grain,
+                   const T& identity, Accumulate&& accumulate, Combine&& combine,
+                   TaskPriority priority = TASK_PRIORITY_NORMAL)
+{
+    // One cache line per partial, so participants do not share lines (and
+    // so T = bool is stored as a bool rather than a packed vector<bool> bit).
+    struct alignas(64) __PARTIAL { T value; };
+    std::vector<__PARTIAL> partials (pool ? pool->thread_count() + 1 : 1, __PARTIAL {identity});
+    __INTERNAL__parallel_chunks(pool, begin, end, grain,
+    [&](uint32_t slot, TileIndex first, TileIndex last) {
+        T& partial = partials[slot].value;
+        for (TileIndex tile = first; tile < last; ++tile)
+            partial = accumulate(std::move(partial), tile);
+    }, priority);
+    T result = identity;
+    for (auto& partial : partials)
+        result = combine(std::move(result), std::move(partial.value));
+    return result;
+}
+
+// MARK: - COROUTINES
+/**
+ * @brief Awaitable form of a fence: `bool ran = co_await fence;`
+ *
+ * The awaiting coroutine is resumed by the thread that signals the fence (typically
+ * the pool worker that completed the task), or continues immediately if the fence is
+ * null or already signalled. Evaluates to false if the fenced task was cancelled.
+ */
+struct FenceAwaiter {
+    Fence                           fence;
+    bool await_ready                () const noexcept { return !fence || fence->complete; }
+    bool await_suspend              (std::coroutine_handle<> handle) {
+        return fence->add_continuation([handle]{ handle.resume(); });
+    }
+    bool await_resume               () const noexcept { return !fence || !fence->cancelled; }
+};
+inline FenceAwaiter operator co_await (const Fence& fence) { return FenceAwaiter {fence}; }
+
+template <class T = void> class Task;
+struct __INTERNAL__PromiseBase {
+    std::coroutine_handle<>         continuation;   // Coroutine awaiting the unstarted task
+    Fence                           completion;     // Signalled on completion of a started task
+    std::exception_ptr              exception;
+
+    struct FinalAwaiter {
+        bool await_ready            () const noexcept { return false; }
+        template <class Promise>
+        std::coroutine_handle<> await_suspend (std::coroutine_handle<Promise> handle) noexcept {
+            // Copy out before signalling; a woken waiter may destroy this frame.
+            auto continuation       = handle.promise().continuation;
+            auto completion         = handle.promise().completion;
+            if (completion) completion->signal();
+            if (continuation) return continuation;
+            return std::noop_coroutine();
+        }
+        void await_resume           () const noexcept { }
+    };
+    std::suspend_always initial_suspend () const noexcept { return {}; }
+    FinalAwaiter final_suspend      () const noexcept { return {}; }
+    void unhandled_exception        () noexcept { exception = std::current_exception(); }
+};
+template <class T>
+struct __INTERNAL__Promise : public __INTERNAL__PromiseBase {
+    std::optional<T>                value;
+
+    Task<T> get_return_object       ();
+    template <class U>
+    void return_value               (U&& result) { value.emplace(std::forward<U>(result)); }
+    T take                          () {
+        if (exception) std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+template <>
+struct __INTERNAL__Promise<void> : public __INTERNAL__PromiseBase {
+    Task<void> get_return_object    ();
+    void return_void                () const noexcept { }
+    void take                       () const {
+        if (exception) std::rethrow_exception(exception);
+    }
+};
+/**
+ * @brief Lazily started coroutine producing a T (or an exception).
+ *
+ * The coroutine does not run until it is awaited or started. `co_await task` runs an
+ * unstarted task on the awaiting thread and resumes the awaiting coroutine upon its
+ * completion, without blocking a thread; combine with schedule() to move onto the pool.
+ * start() runs the task until its first suspension and returns a fence, which allows
+ * one thread to keep any number of tasks outstanding at once:
+ *
+ *     std::vector<Task<Buffer>> reads;
+ *     for (auto tile : tiles) reads.push_back(async_invoke(pool, [=]{ return read(tile); }));
+ *     for (auto& read : reads) read.start();
+ *     for (auto& read : reads) send(co_await read);
+ *
+ * \warning A started task must outlive its completion. Await or start a task only once.
+ */
+template <class T>
+class [[nodiscard]] Task {
+public:
+    using promise_type      = __INTERNAL__Promise<T>;
+    using Handle            = std::coroutine_handle<promise_type>;
+
+    Task                            () = default;
+    explicit Task                   (Handle handle) : _handle (handle) { }
+    Task                            (Task&& other) noexcept :
+    _handle                         (std::exchange(other._handle, nullptr)) { }
+    Task& operator =                (Task&& other) noexcept {
+        if (this != &other) {
+            if (_handle) _handle.destroy();
+            _handle = std::exchange(other._handle, nullptr);
+        }   return *this;
+    }
+    Task                            (const Task&) = delete;
+    Task& operator =                (const Task&) = delete;
+   ~Task                            () { if (_handle) _handle.destroy(); }
+    explicit operator bool          () const noexcept { return static_cast<bool>(_handle); }
+    /**
+     * @brief Run the task on the calling thread until it first suspends.
+     *
+     * @return Fence signalled when the task completes (see result())
+     */
+    Fence start () {
+        auto& promise = _handle.promise();
+        if (!promise.completion) {
+            promise.completion = createFence();
+            _handle.resume();
+        }   return promise.completion;
+    }
+    /// @brief Value produced by a completed task. Rethrows an exception thrown by the task.
+    T result () { return _handle.promise().take(); }
+
+    struct Awaiter {
+        Handle                      handle;
+        bool await_ready            () const noexcept {
+            auto& completion        = handle.promise().completion;
+            return completion && completion->complete;
+        }
+        std::coroutine_handle<> await_suspend (std::coroutine_handle<> awaiting) {
+            auto& promise           = handle.promise();
+            if (!promise.completion) {      // Unstarted; transfer to it directly
+                promise.continuation = awaiting;
+                return handle;
+            }
+            if (promise.completion->add_continuation([awaiting]{ awaiting.resume(); }))
+                return std::noop_coroutine();
+            return awaiting;                // Completed in the meantime
+        }
+        T await_resume              () { return handle.promise().take(); }
+    };
+    Awaiter operator co_await       () & noexcept { return Awaiter {_handle}; }
+    Awaiter operator co_await       () && noexcept { return Awaiter {_handle}; }
+private:
+    Handle                          _handle = nullptr;
+};
+template <class T>
+inline Task<T> __INTERNAL__Promise<T>::get_return_object () {
+    return Task<T> {Task<T>::Handle::from_promise(*this)};
+}
+inline Task<void> __INTERNAL__Promise<void>::get_return_object () {
+    return Task<void> {Task<void>::Handle::from_promise(*this)};
+}
+/**
+ * @brief Block the calling thread until a task completes and return its result.
+ *
+ * Bridges coroutine code into blocking code, such as a main thread or a test.
+ * \warning Do not call from a pool worker of a pool the task needs to progress.
+ */
+template <class T>
+T sync_wait (Task<T> task)
+{
+    task.start()->wait_on_signal();
+    return task.result();
+}
+/**
+ * @brief Invoke a function on a pool worker from within a coroutine.
+ *
+ * Coroutine-returning form of a blocking call, such as a tile read:
+ * `Buffer tile = co_await async_invoke(pool, [=]{ return read_slide_tile(info); });`
+ * The awaiting coroutine continues on the worker that ran the function.
+ */
+template <class Function>
+auto async_invoke (ThreadPool pool, Function function,
+                   TaskPriority priority = TASK_PRIORITY_NORMAL)
+-> Task<std::invoke_result_t<Function&>>
+{
+    co_await pool->schedule(priority);
+    co_return function();
+}
+
+// MARK: - FUTURES
+/// Fence that also carries the result of the task it fences.
+template <class T>
+struct __INTERNAL__FutureState : public __INTERNAL__Fence {
+    std::optional<T>                value;
+    std::exception_ptr              exception;
+
+    template <class Function>
+    void run (Function& function) {
+        try { value.emplace(function()); }
+        catch (...) { exception = std::current_exception(); }
+    }
 };
+template <>
+struct __INTERNAL__FutureState<void> : public __INTERNAL__Fence {
+    std::exception_ptr              exception;
 
+    template <class Function>
+    void run (Function& function) {
+        try { function(); }
+        catch (...) { exception = std::current_exception(); }
+    }
+};
+template <class T, class Function>
+struct __INTERNAL__ContinuationResult { using type = std::invoke_result_t<Function&, T&>; };
+template <class Function>
+struct __INTERNAL__ContinuationResult<void, Function> { using type = std::invoke_result_t<Function&>; };
+/**
+ * @brief Result of a task issued with __INTERNAL__Pool::submit: a value or the exception it threw.
+ *
+ * Futures are cheap to copy; copies share the result. The future may be polled with
+ * ready(), waited upon with or without a deadline, chained with then(), awaited within
+ * a coroutine, or converted to a Fence to join it with other work.
+ */
+template <class T>
+class Future {
+    using State = __INTERNAL__FutureState<T>;
+    std::shared_ptr<State>          _state;
+public:
+    Future                          () = default;
+    explicit Future                 (std::shared_ptr<State> state) : _state (std::move(state)) { }
+    /// @brief Create the shared state of a future, from the pool of recycled fences.
+    static Future create () {
+        return Future (std::allocate_shared<State>(__INTERNAL__RecyclingAllocator<State>()));
+    }
+    explicit operator bool          () const noexcept { return static_cast<bool>(_state); }
+    /// @brief Whether the task has completed (or was cancelled), without blocking.
+    bool ready                      () const { return _state->complete; }
+    /// @brief Block until the task has completed.
+    void wait                       () const { _state->wait_on_signal(); }
+    /// @brief Block until the task has completed or the deadline passes; true if completed.
+    bool wait_until                 (TimePoint deadline) const { return _state->wait_until(deadline); }
+    /// @brief Block until the task has completed or the timeout elapses; true if completed.
+    template <class Rep, class Period>
+    bool wait_for                   (std::chrono::duration<Rep, Period> timeout) const {
+        return wait_until(std::chrono::steady_clock::now() + timeout);
+    }
+    /**
+     * @brief Wait for the task and return its value (which may be moved from).
+     *
+     * @throws the exception thrown by the task, or std::runtime_error if the task
+     * was cancelled before it ran
+     */
+    std::add_lvalue_reference_t<T> get () const {
+        wait();
+        if (_state->exception) std::rethrow_exception(_state->exception);
+        if (_state->cancelled) throw std::runtime_error("Iris Async task was cancelled before it ran");
+        if constexpr (!std::is_void_v<T>) return *_state->value;
+    }
+    /// @brief The fence signalled when the task completes (ex: for wait_all or issue_task_after).
+    Fence fence                     () const { return _state; }
+    /**
+     * @brief Issue a task that receives this future's value once it is ready.
+     *
+     * The function is invoked with the value (with no argument for Future<void>) as a
+     * pool task. If this future's task threw or was cancelled, the function is not invoked
+     * and the returned future carries that exception instead.
+     */
+    template <class Function>
+    auto then (const ThreadPool&, Function, TaskPriority = TASK_PRIORITY_NORMAL,
+               const CancelToken& = nullptr) const;
+
+    struct Awaiter : public FenceAwaiter {
+        Future                      future;
+        decltype(auto) await_resume () const { return future.get(); }
+    };
+    /// @brief `T& value = co_await future;` (see FenceAwaiter)
+    Awaiter operator co_await       () const { return Awaiter {{_state}, *this}; }
+};
+template <class Function>
+auto __INTERNAL__Pool::submit (Function function, TaskPriority priority, const CancelToken& token)
+-> Future<std::invoke_result_t<Function&>>
+{
+    using Result = std::invoke_result_t<Function&>;
+    auto future = Future<Result>::create();
+    auto state  = std::static_pointer_cast<__INTERNAL__FutureState<Result>>(future.fence());
+    // The callback holds the state as its fence, so the task may reference it directly.
+    if (!issue_with_fence([state = state.get(), function = std::move(function)] () mutable {
+        state->run(function);
+    }, state, priority, token)) {
+        state->exception = std::make_exception_ptr
+        (std::runtime_error("Iris Async task submitted to an inactive pool"));
+        state->signal();
+    }   return future;
+}
+template <class T>
+template <class Function>
+auto Future<T>::then (const ThreadPool& pool, Function function, TaskPriority priority,
+                      const CancelToken& token) const
+{
+    using Result = typename __INTERNAL__ContinuationResult<T, Function>::type;
+    auto future = Future<Result>::create();
+    auto state  = std::static_pointer_cast<__INTERNAL__FutureState<Result>>(future.fence());
+    if (!pool->issue_after({_state}, [antecedent = _state, state = state.get(),
+                                      function = std::move(function)] () mutable {
+        if (antecedent->exception) state->exception = antecedent->exception;
+        else if (antecedent->cancelled) state->exception = std::make_exception_ptr
+        (std::runtime_error("Iris Async task was cancelled before it ran"));
+        else if constexpr (std::is_void_v<T>) state->run(function);
+        else {
+            auto invoke = [&] () -> decltype(auto) { return function(*antecedent->value); };
+            state->run(invoke);
+        }
+    }, state, priority, token)) {
+        state->exception = std::make_exception_ptr
+        (std::runtime_error("Iris Async task submitted to an inactive pool"));
+        state->signal();
+    }   return future;
+}
 
 } // END ASYNC NAMESPACE
 } // END IRIS NAMESAPCE
@@ -13,9 +13,65 @@
 #ifndef IrisBuffer_hpp
 #define IrisBuffer_hpp
 
-//TODO: THIS IS CURRENTLY NOT THREAD SAFE! THERE CAN BE DATA RACES WITH THE CURRENT FORM. MUST UPDATE TO USE ATOMIC AND MUTEXES FOR THREAD SAFETY!
+#ifndef IRIS_BUFFER_ALIGNMENT
+#define IRIS_BUFFER_ALIGNMENT 64U
+#endif
+#ifndef IRIS_BUFFER_HUGE_PAGE_SIZE
+#define IRIS_BUFFER_HUGE_PAGE_SIZE (2U << 20)
+#endif
+#ifndef IRIS_BUFFER_NUMA_PAGE_SIZE
+#define IRIS_BUFFER_NUMA_PAGE_SIZE 4096U
+#endif
+#ifndef IRIS_BUFFER_NUMA_MAX_NODES
+#define IRIS_BUFFER_NUMA_MAX_NODES 1024U
+#endif
+#ifndef IRIS_TILE_POOL_LIMIT
+#define IRIS_TILE_POOL_LIMIT (256U * TILE_PIX_BYTES_RGBA)
+#endif
+#ifndef IRIS_TILE_POOL_THREAD_BLOCKS
+#define IRIS_TILE_POOL_THREAD_BLOCKS 8U
+#endif
+
+#if !defined _WIN32
+#include <sys/uio.h>
+#endif
 
 namespace Iris {
+#if defined _WIN32
+using NativeFileHandle = HANDLE;
+/// Scatter-gather element (matches the POSIX struct iovec layout)
+struct iovec {
+    void*                           iov_base;
+    size_t                          iov_len;
+};
+#else
+using NativeFileHandle = int;
+#endif
+/**
+ * @brief Access pattern hints for mapped buffers (see __INTERNAL__Buffer::advise)
+ */
+enum BufferAdvice : uint8_t {
+    /// @brief No special treatment (default read-ahead)
+    BUFFER_ADVICE_NORMAL        = 0,
+    /// @brief The region will be accessed soon; begin reading it in
+    BUFFER_ADVICE_WILLNEED      = 1,
+    /// @brief The region will be read sequentially; read ahead aggressively
+    BUFFER_ADVICE_SEQUENTIAL    = 2,
+    /// @brief The region will not be needed soon; its pages may be dropped
+    BUFFER_ADVICE_DONTNEED      = 3,
+};
+/**
+ * @brief Capacity growth policy applied when an append exceeds a buffer's capacity
+ * (see __INTERNAL__Buffer::set_growth_policy)
+ */
+enum BufferGrowthPolicy : uint8_t {
+    /// @brief Grow to exactly the required capacity (default). Best for buffers of known final size.
+    BUFFER_GROWTH_EXACT         = 0,
+    /// @brief Grow to the larger of the required capacity and the current capacity times the growth factor.
+    BUFFER_GROWTH_GEOMETRIC     = 1,
+    /// @brief Grow to the required capacity rounded up to a whole number of memory pages.
+    BUFFER_GROWTH_PAGE          = 2,
+};
 /**
  * @brief Private implementation of the reference counted data object used to wrap datablocks.
  *
@@ -28,19 +84,36 @@ namespace Iris {
  * who want greater efficiency and control over datablocks. These methods
  * were created for the internal use by Iris Developers and come with some inherant risk.
  *
- * \warning __INTERNAL__Buffer is currently NOT thread safe. This will be fixed
- * in future updates. 
+ * \warning The single-writer methods (append(), prepare(), change_capacity(), etc...)
+ * are NOT thread safe with respect to one another. Concurrent writers must use the
+ * concurrent append methods (reserve_concurrent(), write_concurrent(), and
+ * append_concurrent()) and concurrent readers must hold the lock returned by
+ * lock_for_reading() while dereferencing data().
  */
-class __INTERNAL__Buffer {
+class __INTERNAL__Buffer : public std::enable_shared_from_this<__INTERNAL__Buffer> {
     BufferReferenceStrength         _strength   = REFERENCE_STRONG;
-    size_t                          _capacity   = 0;
-    size_t                          _size       = 0;
+    BufferCreateFlags               _flags      = BUFFER_CREATE_DEFAULT;
+    uint16_t                        _node       = IRIS_NUMA_NODE_ANY;
+    BufferGrowthPolicy              _growth     = BUFFER_GROWTH_EXACT;
+    float                           _factor     = 2.f;
+    BufferTag                       _tag        = BUFFER_TAG_UNTAGGED;
+    Format                          _format     = FORMAT_UNDEFINED;
+    atomic_size                     _capacity   = 0;
+    atomic_size                     _size       = 0;
     void* const                     _data       = nullptr;
+    void*                           _map_base   = nullptr;  // Mapped references only
+    size_t                          _map_length = 0;        // Mapped references only
+    Buffer                          _parent     = nullptr;  // Slices only; owns the block
+    atomic_uint32                   _views      = 0;        // Live slices of this block
+    mutable SharedMutex             _resize;    // Guards _data relocation
     
 public:
     explicit __INTERNAL__Buffer     (BufferReferenceStrength) noexcept;
     explicit __INTERNAL__Buffer     (BufferReferenceStrength, size_t capacity) noexcept;
+    explicit __INTERNAL__Buffer     (BufferReferenceStrength, size_t capacity, BufferCreateFlags,
+                                     uint16_t numa_node = IRIS_NUMA_NODE_ANY) noexcept;
     explicit __INTERNAL__Buffer     (BufferReferenceStrength, const void* const data, size_t bytes) noexcept;
+    explicit __INTERNAL__Buffer     (BufferReferenceStrength, NativeFileHandle, size_t offset, size_t bytes) noexcept;
     __INTERNAL__Buffer              (const __INTERNAL__Buffer&) = delete;
     __INTERNAL__Buffer& operator =  (const __INTERNAL__Buffer&) = delete;
    ~__INTERNAL__Buffer              ();
@@ -62,6 +135,7 @@ public:
      * 
      * @return REFERENCE_WEAK if the buffer only references the data and does not own it 
      * @return REFERENCE_STRONG if the buffer owns the data and controls the data lifetime
+     * @return REFERENCE_MAPPED if the buffer owns a read-only mapping of a file region
      */
     /// 
     BufferReferenceStrength get_strength    () const;
@@ -74,9 +148,89 @@ public:
      * If switched to WEAK reference, the buffer will give up the responsibility to free the data
      * and it now becomes the **responsibility of the program to avoid a memory leak**.
      * 
+     * \note Mapped buffers and slices cannot change strength and no buffer may become mapped.
+     * 
      * @param strength_to_assign REFERENCE_WEAK or REFERENCE_STRONG
+     * @return IRIS_FAILURE if either the current or assigned strength is REFERENCE_MAPPED
+     * or this buffer is a slice of another buffer
      */
     Result      change_strength             (BufferReferenceStrength strength_to_assign);
+    /**
+     * @brief Get the allocation flags of the underlying data block.
+     *
+     * Aligned blocks remain aligned when grown via prepare(), append(), or change_capacity().
+     * \sa BufferCreateFlags
+     *
+     * @return BufferCreateFlags bit-mask used to allocate the data block
+     */
+    BufferCreateFlags get_flags             () const;
+    /**
+     * @brief Get the NUMA node on which the data block was placed.
+     *
+     * @return IRIS_NUMA_NODE_ANY if the block was not bound to a specific node
+     */
+    uint16_t    get_numa_node               () const;
+    /**
+     * @brief Set the capacity growth policy used when appending beyond the capacity.
+     *
+     * Exact growth (the default) reallocates to exactly the required size, which is
+     * ideal for buffers written once but copies the whole block on every append when
+     * streaming many small writes. Geometric growth amortizes that cost to O(1) per byte
+     * and page growth rounds each reallocation to whole memory pages.
+     * \sa BufferGrowthPolicy, reserve_hint()
+     *
+     * @param policy growth policy to apply to subsequent appends
+     * @param factor multiplier for BUFFER_GROWTH_GEOMETRIC (values below 1.125 are clamped)
+     * @return IRIS_SUCCESS on success
+     */
+    Result      set_growth_policy           (BufferGrowthPolicy policy, float factor = 2.f);
+    /**
+     * @brief Get the capacity growth policy of this buffer.
+     */
+    BufferGrowthPolicy get_growth_policy    () const;
+    /**
+     * @brief Ensure the capacity is at least the expected total number of bytes.
+     *
+     * Use this when the eventual size of a streamed buffer is known or can be estimated,
+     * so the block is allocated once rather than grown repeatedly. This never shrinks the
+     * buffer and has no effect on the size.
+     *
+     * @param expected_total_bytes total number of bytes the buffer is expected to hold
+     * @return IRIS_SUCCESS if the capacity is at least expected_total_bytes
+     */
+    Result      reserve_hint                (size_t expected_total_bytes);
+    /**
+     * @brief Attribute this buffer's memory to a subsystem for allocation accounting.
+     *
+     * The block currently owned by the buffer (its bytes and its allocation count)
+     * is moved to the new tag, so each tag's allocations less releases is the number
+     * of live blocks attributed to it.
+     * \sa Get_buffer_allocation_stats()
+     *
+     * @param tag accounting tag
+     * @return IRIS_SUCCESS on success
+     */
+    Result      set_tag                     (BufferTag tag);
+    /**
+     * @brief Get the allocation accounting tag of this buffer.
+     */
+    BufferTag   get_tag                     () const;
+    /**
+     * @brief Describe the pixel layout of the data held by this buffer.
+     *
+     * The format is descriptive only and does not alter the data. It allows
+     * consumers, such as the Python buffer protocol, to interpret tile pixel data
+     * as a (TILE_PIX_LENGTH, TILE_PIX_LENGTH, channels) array without a copy.
+     *
+     * @param format pixel format of the contained tile data or FORMAT_UNDEFINED
+     */
+    void        set_format                  (Format format);
+    /**
+     * @brief Get the pixel format of the data held by this buffer.
+     *
+     * @return FORMAT_UNDEFINED if the buffer does not contain formatted tile pixels
+     */
+    Format      get_format                  () const;
     /**
      * @brief Returns pointer to the **beginning** of the underlying data block
      * 
@@ -156,6 +310,9 @@ public:
      * This is distinct from the buffer capacity
      * \sa capacity()
      * 
+     * \note While concurrent appenders are active, this includes regions they have
+     * reserved but not yet written (see reserve_concurrent()).
+     * 
      * @return size_t number of bytes written to the buffer.
      */
     size_t      size                        () const;
@@ -203,6 +360,8 @@ public:
      * if resize changed the buffer by evaluating a comparison between data() before calling
      * and data() after calling.
      * 
+     * \note This fails while slices of this buffer exist. \sa slice()
+     * 
      * @param new_buffer_capacity Size in bytes the buffer should be
      * @return IRIS_SUCCESS on successfully resizing the buffer object
      */
@@ -217,7 +376,252 @@ public:
      * @return IRIS_SUCCESS on successfully resizing the buffer object
      */
     Result      shrink_to_fit               ();
+    /**
+     * @brief Advise the kernel of the expected access pattern of a mapped buffer.
+     *
+     * This forwards the hint to madvise for the mapped region. WILLNEED begins
+     * asynchronous read-ahead of the region (useful before handing a tile bytestream
+     * to a decoder), SEQUENTIAL enables aggressive read-ahead for streaming, and DONTNEED
+     * allows the kernel to drop the (clean) pages; they are re-read from the file on next access.
+     *
+     * \note Hints are advisory and are accepted without effect on platforms without madvise.
+     *
+     * @param advice access pattern hint
+     * @return IRIS_SUCCESS if the hint was accepted
+     * @return IRIS_FAILURE if this is not a mapped buffer or the hint was rejected
+     */
+    Result      advise                      (BufferAdvice advice) const;
+    /**
+     * @brief Create a zero-copy child buffer over a sub-range of this buffer.
+     *
+     * The child wraps [offset, offset + bytes) of this buffer's data block with no copy
+     * and holds a strong reference to this buffer, so the block outlives every slice
+     * regardless of which handle is released first. This allows a single large read
+     * (for example a span of many compressed tiles) to be split into per-tile buffers.
+     *
+     * The child has size and capacity equal to bytes and behaves as a weak reference:
+     * it cannot be resized or strengthened. While any slice exists, this buffer's data
+     * block cannot be relocated and change_capacity() (or any growth) will fail.
+     *
+     * \note This buffer must be owned by an Iris::Buffer (std::shared_ptr).
+     *
+     * @param offset byte offset of the start of the slice within this buffer
+     * @param bytes length of the slice in bytes
+     * @return Valid Iris::Buffer slice on success
+     * @return Nullptr if the range exceeds size() or this buffer is not shared-owned
+     */
+    Buffer      slice                       (size_t offset, size_t bytes);
+    /**
+     * @brief Reserve space at the end of the buffer for a concurrent writer.
+     *
+     * The write cursor (size) is advanced with an atomic compare-exchange so any
+     * number of threads may reserve space simultaneously without locking. If the
+     * reservation extends beyond the current capacity, the block is grown
+     * geometrically under an exclusive lock; growth waits for in-flight concurrent
+     * writes to finish before relocating the block. Nothing is reserved if the
+     * block cannot be grown.
+     * \sa write_concurrent(), append_concurrent()
+     *
+     * \note The returned offset remains valid across relocations. Never cache
+     * a data() pointer between reserving and writing; use write_concurrent().
+     *
+     * \warning size() includes regions that have been reserved but not yet written.
+     * Readers must wait for every concurrent appender to finish (ex: join the fences
+     * of the appending tasks) before reading up to size().
+     *
+     * @param bytes number of bytes to reserve
+     * @param offset byte offset of the reserved region from the start of the block
+     * @return IRIS_SUCCESS on successful reservation
+     * @return IRIS_FAILURE if the buffer cannot be expanded (weak reference or allocation failure)
+     */
+    Result      reserve_concurrent          (size_t bytes, size_t& offset);
+    /**
+     * @brief Copy data into a region previously reserved with reserve_concurrent().
+     *
+     * The copy is performed under a shared lock, so many writers may copy at
+     * once while relocation of the block by a growing writer is held off.
+     *
+     * @param offset offset returned by reserve_concurrent()
+     * @param data C-style pointer to data array
+     * @param size Size of data in bytes (must not exceed the reserved region)
+     * @return IRIS_SUCCESS on successful copy
+     */
+    Result      write_concurrent            (size_t offset, const void* data, size_t size);
+    /**
+     * @brief Thread-safe append; equivalent to reserve_concurrent() followed by write_concurrent().
+     *
+     * \note The order of concurrently appended regions is the order in which the
+     * reservations were made, not necessarily the order in which the calls began.
+     *
+     * @param data C-style pointer to data array
+     * @param size Size of data in bytes
+     * @return IRIS_SUCCESS on successful appending of data to end of buffer
+     */
+    Result      append_concurrent           (const void* data, size_t size);
+    /**
+     * @brief Acquire a shared lock that prevents the block from being relocated.
+     *
+     * Readers that dereference data() while other threads may be appending
+     * concurrently must hold this lock for the duration of the access.
+     * Do NOT call any method that may resize the buffer while holding it.
+     *
+     * @return ReadLock that pins the current data block until released
+     */
+    ReadLock    lock_for_reading            () const;
+private:
+    Result      RESIZE_INTERNAL             (size_t new_buffer_capacity);
+    size_t      NEXT_CAPACITY               (size_t required_capacity) const;
+    friend Buffer Create_tile_buffer        (uint8_t channels);
 };
+/**
+ * @brief Map a region of an open file into a **mapped** (read-only) buffer.
+ *
+ * Equivalent to Map_buffer_from_file() but uses an already open file handle
+ * (file descriptor on POSIX systems), avoiding an open() call per region. The handle
+ * may be closed once the buffer is created.
+ *
+ * @param file_handle open, readable native file handle
+ * @param offset byte offset of the start of the region within the file
+ * @param bytes length of the region in bytes
+ * @return Valid Iris::Buffer (**mapped ownership**) handle on success
+ * @return Nullptr on failure
+ * @throws std::runtime_error if the region extends beyond the end of the file
+ */
+Buffer  Map_buffer_from_file_handle         (NativeFileHandle file_handle, size_t offset, size_t bytes);
+// MARK: - BUFFER CHAIN
+/**
+ * @brief Ordered chain of buffer segments for vectored (scatter-gather) writes.
+ *
+ * A chain references many independent buffers (tile bytestreams, offset tables,
+ * metadata blocks) as a single logical bytestream without concatenating them.
+ * The chain holds a reference to every segment's buffer, keeping the data alive
+ * until the chain is cleared or destroyed, and maintains a matching iovec array
+ * that can be handed directly to writev / pwritev. write() and write_at() perform
+ * the complete write with as few system calls as possible (IOV_MAX segments per call),
+ * resuming after partial writes.
+ *
+ * \warning Segment buffers must not be resized while held by a chain, as the iovec
+ * array references their data blocks directly. Slices (see __INTERNAL__Buffer::slice())
+ * pin their parent's block and are always safe to append.
+ * \note A chain is not thread safe; build it on one thread and then write it.
+ */
+class BufferChain {
+    std::vector<Buffer>             _buffers;
+    std::vector<iovec>              _iovecs;
+    size_t                          _size       = 0;
+    
+public:
+    /**
+     * @brief Append the valid bytes [0, size()) of a buffer as a new segment.
+     *
+     * @param buffer Iris::Buffer segment to reference. Empty buffers are ignored.
+     * @return IRIS_SUCCESS on success
+     */
+    Result      append                      (const Buffer& buffer);
+    /**
+     * @brief Append the sub-range [offset, offset + bytes) of a buffer as a new segment.
+     *
+     * @return IRIS_FAILURE if the range exceeds the buffer's size
+     */
+    Result      append                      (const Buffer& buffer, size_t offset, size_t bytes);
+    /**
+     * @brief Total number of bytes across all segments
+     */
+    size_t      size                        () const;
+    /**
+     * @brief Number of segments (entries in the iovec array)
+     */
+    size_t      segment_count               () const;
+    /**
+     * @brief Scatter-gather array describing every segment, in order.
+     *
+     * The array holds segment_count() entries and is valid until the chain is modified.
+     */
+    const iovec* iovecs                     () const;
+    /**
+     * @brief Release every segment reference.
+     */
+    void        clear                       ();
+    /**
+     * @brief Copy every segment into a single new strong buffer.
+     *
+     * This is a fallback for consumers that require contiguous data.
+     * @return Strong Iris::Buffer of size() bytes or nullptr on failure.
+     */
+    Buffer      flatten                     () const;
+    /**
+     * @brief Write the whole chain at the current position of a file (writev).
+     *
+     * @param file_handle open, writable native file handle
+     * @return IRIS_SUCCESS once every byte has been written
+     */
+    Result      write                       (NativeFileHandle file_handle) const;
+    /**
+     * @brief Write the whole chain at an absolute offset of a file (pwritev).
+     *
+     * The file position is not changed, so this may be called concurrently by
+     * multiple chains writing disjoint regions of the same file.
+     *
+     * @param file_handle open, writable native file handle
+     * @param offset byte offset within the file at which to write the first segment
+     * @return IRIS_SUCCESS once every byte has been written
+     */
+    Result      write_at                    (NativeFileHandle file_handle, size_t offset) const;
+};
+// MARK: - TILE BUFFER POOL
+/**
+ * @brief Tile buffer pool counters
+ *
+ * Hits are tile buffers served from a recycled block and misses are
+ * tile buffers that required a fresh allocation. Releases are blocks returned
+ * to a free list on buffer destruction and evictions are blocks freed because
+ * retaining them would have exceeded the retained byte limit.
+ */
+struct TileBufferPoolStats {
+    size_t              retainedBytes   = 0;
+    size_t              retainedLimit   = 0;
+    uint64_t            hits            = 0;
+    uint64_t            misses          = 0;
+    uint64_t            releases        = 0;
+    uint64_t            evictions       = 0;
+};
+/**
+ * @brief Create a **strong** tile pixel buffer from the tile buffer pool.
+ *
+ * Tile buffers are sized for a full 256 x 256 pixel tile (TILE_PIX_BYTES_RGB or
+ * TILE_PIX_BYTES_RGBA capacity and size of 0 bytes) and are allocated with
+ * BUFFER_CREATE_ALIGNED for vectorized pixel routines. When the last copy of the
+ * returned Buffer is destroyed, the data block is returned to a free list owned
+ * by the destroying thread rather than freed, provided the total retained bytes
+ * remain below the pool limit. Lists holding more than IRIS_TILE_POOL_THREAD_BLOCKS
+ * blocks of a size spill into a shared depot, from which empty lists refill, so
+ * tiles allocated on one thread and released on another are still reused.
+ * Blocks whose capacity was changed after creation are freed normally, even if the
+ * new capacity is that of another tile size.
+ *
+ * @param channels number of 8-bit channels per pixel (3 or 4). Other values fall back
+ * to Create_strong_buffer(TILE_PIX_AREA * channels).
+ * @return Valid Iris::Buffer handle with size 0 bytes on success
+ * @return Nullptr on failure
+ */
+Buffer  Create_tile_buffer                  (uint8_t channels);
+/**
+ * @brief Set the maximum number of bytes retained across all tile pool free lists.
+ *
+ * Lowering the limit immediately frees the retained blocks beyond it, from the
+ * shared depot first and then from the free list of each thread.
+ *
+ * @param bytes retained byte limit (default IRIS_TILE_POOL_LIMIT)
+ */
+void    Set_tile_buffer_pool_limit          (size_t bytes);
+/**
+ * @brief Free every block retained by the shared depot and the calling thread's free list.
+ */
+void    Trim_tile_buffer_pool               ();
+/**
+ * @brief Return a snapshot of the tile buffer pool counters.
+ */
+TileBufferPoolStats Get_tile_buffer_pool_stats ();
 } // END IRIS NAMESPACE
 
 #endif /* IrisBuffer_hpp */
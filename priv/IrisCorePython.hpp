@@ -23,6 +23,63 @@ Version _get_version ()
         IRIS_BUILD_NUMBER,
     };
 }
+static inline ssize_t _format_channels (Format format)
+{
+    switch (format) {
+        case FORMAT_B8G8R8:
+        case FORMAT_R8G8B8:     return 3;
+        case FORMAT_B8G8R8A8:
+        case FORMAT_R8G8B8A8:   return 4;
+        default:                return 0;
+    }
+}
+/**
+ * @brief Describe the buffer data block without copying it.
+ * 
+ * Buffers holding a full tile in a defined format are exposed as
+ * (TILE_PIX_LENGTH, TILE_PIX_LENGTH, channels) uint8 arrays; all
+ * other buffers are exposed as a flat uint8 array of size() bytes.
+ * Mapped buffers are exposed as read-only.
+ */
+py::buffer_info _buffer_info (__INTERNAL__Buffer& buffer)
+{
+    const ssize_t bytes     = static_cast<ssize_t>(buffer.size());
+    const ssize_t channels  = _format_channels(buffer.get_format());
+    const bool    readonly  = buffer.get_strength() == REFERENCE_MAPPED;
+    if (channels && bytes == static_cast<ssize_t>(TILE_PIX_AREA) * channels)
+        return py::buffer_info (buffer.data(), sizeof(uint8_t),
+                                py::format_descriptor<uint8_t>::format(), 3,
+                                {static_cast<ssize_t>(TILE_PIX_LENGTH),
+                                 static_cast<ssize_t>(TILE_PIX_LENGTH), channels},
+                                {static_cast<ssize_t>(TILE_PIX_LENGTH) * channels, channels,
+                                 static_cast<ssize_t>(sizeof(uint8_t))},
+                                readonly);
+    return py::buffer_info (buffer.data(), sizeof(uint8_t),
+                            py::format_descriptor<uint8_t>::format(), 1,
+                            {bytes}, {static_cast<ssize_t>(sizeof(uint8_t))},
+                            readonly);
+}
+/**
+ * @brief NumPy array interface (version 3) of the buffer data block.
+ * 
+ * NumPy retains a reference to the Python buffer object while the
+ * array exists, which keeps the underlying data block alive.
+ */
+py::dict _array_interface (__INTERNAL__Buffer& buffer)
+{
+    auto info = _buffer_info(buffer);
+    py::tuple shape (info.ndim);
+    for (ssize_t dim = 0; dim < info.ndim; ++dim)
+        shape[dim] = info.shape[dim];
+    
+    py::dict interface;
+    interface["version"]    = 3;
+    interface["shape"]      = shape;
+    interface["typestr"]    = "|u1";
+    interface["strides"]    = py::none();
+    interface["data"]       = py::make_tuple(reinterpret_cast<uintptr_t>(info.ptr), info.readonly);
+    return interface;
+}
 }
 static inline void DEFINE_IRIS_CORE_SUBMODULE (pybind11::module_& base)
 {
@@ -54,6 +111,7 @@ static inline void DEFINE_IRIS_CORE_SUBMODULE (pybind11::module_& base)
         .def_readonly("value",      &Result::flag)
         .def_readonly("message",    &Result::message);
     py::enum_<Iris::Format>                                 (m, "Format")
+        .value("FORMAT_UNDEFINED",  Iris::FORMAT_UNDEFINED)
         .value("FORMAT_B8G8R8",     Iris::FORMAT_B8G8R8)
         .value("FORMAT_R8G8B8",     Iris::FORMAT_R8G8B8)
         .value("FORMAT_B8G8R8A8",   Iris::FORMAT_B8G8R8A8)
@@ -69,15 +127,27 @@ static inline void DEFINE_IRIS_CORE_SUBMODULE (pybind11::module_& base)
         .def_readonly("layers",     &Extent::layers);
     py::enum_<Iris::BufferReferenceStrength>                (m, "BufferStrength")
         .value("REFERENCE_WEAK",    REFERENCE_WEAK)
-        .value("REFERENCE_STRONG",  REFERENCE_STRONG);
+        .value("REFERENCE_STRONG",  REFERENCE_STRONG)
+        .value("REFERENCE_MAPPED",  REFERENCE_MAPPED);
     
     m.def("get_version",            &Iris::_get_version,
           "Get the Iris Core module version associated with this package");
     
-    py::class_<Iris::__INTERNAL__Buffer, Iris::Buffer>      (m, "Buffer")
+    // Buffers support the Python buffer protocol and the NumPy array interface
+    // so numpy.asarray(buffer) and memoryview(buffer) share the data block
+    // without a copy. Do not resize a buffer while such views exist, as growing
+    // the buffer may relocate the data block out from under the view.
+    py::class_<Iris::__INTERNAL__Buffer, Iris::Buffer>      (m, "Buffer", py::buffer_protocol())
         .def(py::init<BufferReferenceStrength>())
         .def(py::init<BufferReferenceStrength,size_t>())
-        .def("get_strength",        &__INTERNAL__Buffer::get_strength);
-//        .def("data",                &__INTERNAL__Buffer::data);
+        .def("get_strength",        &__INTERNAL__Buffer::get_strength)
+        .def("size",                &__INTERNAL__Buffer::size)
+        .def("capacity",            &__INTERNAL__Buffer::capacity)
+        .def_property("format",     &__INTERNAL__Buffer::get_format,
+                                    &__INTERNAL__Buffer::set_format)
+        .def_buffer                 (&_buffer_info)
+        .def_property_readonly("__array_interface__", &_array_interface)
+        .doc() = "Reference counted data block. Tile pixel buffers convert to "
+                 "NumPy arrays without a copy via numpy.asarray(buffer).";
 
 }
@@ -53,7 +53,7 @@ struct Entry {
     EntryFlag                   flag;
     explicit Entry              () :
     flag                        (ENTRY_FREE) {}
-    static_assert(std::is_copy_constructible_v<T>, "Entries within Iris lockless queues must be copiable");
+    static_assert(std::is_move_constructible_v<T>, "Entries within Iris lockless queues must be movable");
 };
 
 /// NodePtr is a
@@ -169,6 +169,22 @@ public:
     {
         return i < NODE_SIZE ? &_e[i] : nullptr;
     }
+    /// Reserve up to 'wanted' contiguous entries from the front of the node.
+    /// The front is only ever raised to NODE_SIZE (never beyond) so it cannot wrap.
+    /// Returns the number reserved (0 if the node is full) and the first index.
+    uint16_t get_front_range    (uint16_t wanted, uint16_t& first)
+    {
+        uint16_t front = _front.load(std::memory_order_relaxed);
+        while (front < NODE_SIZE) {
+            uint16_t count = wanted < NODE_SIZE - front ? wanted : NODE_SIZE - front;
+            if (_front.compare_exchange_weak(front, front + count,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+                first = front;
+                return count;
+            }
+        } return 0;
+    }
 private:
     /// Extend chain is a THREAD SAFE call that will extend the chain by as many threads that call it.
     /// Guaranteed to create a new node when called and insert it in a thread-safe stack manner
@@ -186,7 +202,7 @@ private:
         while (!next->compare_exchange_weak(END_TEST_NODE,
                                             NODE_TO_ADD_TO_CHAIN,
                                             std::memory_order_release,
-                                            std::memory_order_relaxed)) {
+                                            std::memory_order_acquire)) {
             // There is another link in the chain,
             // this link was returned in END_TEST_NODE.
             // Progress next with the addr of the next ptr in the chain
@@ -331,6 +347,19 @@ public:
     Iterator                    (const Iterator& o) :
     _node                       (o._node),
     _index                      (o._index){}
+    Iterator& operator =        (const Iterator& o) {
+        _node   = o._node;
+        _index  = o._index;
+        return *this;
+    }
+    /// True if this iterator is behind o in the same queue (o's node is reached
+    /// by following this iterator's node chain). Both must be held while compared.
+    bool precedes               (const Iterator& o) const {
+        if (_node == o._node) return _index < o._index;
+        for (NodePtr<T> node = _node->_next; node; node = node->_next)
+            if (node == o._node) return true;
+        return false;
+    }
     bool pop                    (T& reference) {
         
         // This will always check the current node first
@@ -343,7 +372,7 @@ public:
             if (entry) {
                 __EntryFlag FLAG = ENTRY_PENDING;
                 if (entry->flag.compare_exchange_strong(FLAG, ENTRY_READING)) {
-                    reference       = entry->handle;
+                    reference       = std::move(entry->handle);
                     entry->handle   = T();
                     entry->flag.store(ENTRY_COMPLETE);
                     return true;
@@ -435,7 +464,7 @@ public:
     _head                       (_tail._ptr.load()) {}
     Queue                       (const Queue&) = delete;
     Queue& operator =           (const Queue&) = delete;
-    void push                   (const T& reference)
+    void push                   (T reference)
     {
         auto tail = _tail;
         if (!tail) throw std::runtime_error("Failed to push entry. No valid tail\n");
@@ -458,38 +487,81 @@ public:
                     
                 // It should have been a free space
                 case ENTRY_FREE:
-                    entry->handle   = reference;
+                    entry->handle   = std::move(reference);
                     entry->flag     = ENTRY_PENDING;
                     return;
             }
         }
         
         while (entry == nullptr) {
-            // Copy construct a shared_ptr to the next in the tail
-            auto next = tail->_next;
-            
-            // If there is not another link in the chain,
-            // Grow the chain. Each concurrent thread will add a link
-            // any new unused links will be used in subsequent calls.
-            // (chain extension will probably happen in bursts)
-            if (next == nullptr) {
-                tail->extend_chain();
-                next = tail->_next;
-                assert (next && "Chain extension failed.\n");
-            }
-            
-            if (next) _tail.compare_exchange(tail, next);
-            
-            tail    = _tail;
+            ADVANCE_TAIL(tail);
             entry   = tail->get_front();
         }
         // A valid entry exits in var entry, go to insertion.
         goto INSERT_ENTRY;
     }
+    /// Push a contiguous run of entries. Entries are reserved a node at a time
+    /// (one atomic reservation per node rather than one per entry) and are
+    /// published in order. The entries are moved from.
+    void push                   (T* references, size_t count)
+    {
+        auto tail = _tail;
+        if (!tail) throw std::runtime_error("Failed to push entries. No valid tail\n");
+        
+        while (count) {
+            uint16_t first      = 0;
+            uint16_t reserved   = tail->get_front_range
+            (count < NODE_SIZE ? static_cast<uint16_t>(count) : NODE_SIZE, first);
+            
+            for (uint16_t index = 0; index < reserved; ++index) {
+                Entry<T>* entry = tail->get_at(first + index);
+                __EntryFlag FLAG = entry->flag.exchange(ENTRY_WRITING);
+                assert(FLAG == ENTRY_FREE && "ERROR: Entry was not empty");
+                (void)FLAG;
+                entry->handle   = std::move(references[index]);
+                entry->flag     = ENTRY_PENDING;
+            }
+            references  += reserved;
+            count       -= reserved;
+            
+            // The node is exhausted; continue within the next node.
+            if (count) ADVANCE_TAIL(tail);
+        }
+    }
     Iterator<T> begin () const
     {
         return Iterator (_head.load(std::memory_order_acquire));
     }
+    /// Iterator beginning at the tail node. Unlike begin(), this may be taken while
+    /// other iterators are releasing the head, as the queue holds the tail. Entries
+    /// in earlier nodes are not visited; those are left to the existing iterators.
+    Iterator<T> begin_at_tail () const
+    {
+        auto tail = _tail;
+        return Iterator (*tail);
+    }
+private:
+    // Move the tail to the next link in the chain, and update the
+    // local tail copy to the (possibly newer) queue tail.
+    void ADVANCE_TAIL           (NodePtr<T>& tail)
+    {
+        // Copy construct a shared_ptr to the next in the tail
+        auto next = tail->_next;
+        
+        // If there is not another link in the chain,
+        // Grow the chain. Each concurrent thread will add a link
+        // any new unused links will be used in subsequent calls.
+        // (chain extension will probably happen in bursts)
+        if (next == nullptr) {
+            tail->extend_chain();
+            next = tail->_next;
+            assert (next && "Chain extension failed.\n");
+        }
+        
+        if (next) _tail.compare_exchange(tail, next);
+        
+        tail    = _tail;
+    }
 };
 } // END NAMESPACE FIFO
 
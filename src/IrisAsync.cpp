@@ -5,8 +5,20 @@
 //  Created by Ryan Landvater on 10/4/23.
 //
 #include <assert.h>
+#include <bit>
 #include <sstream>
 #include <iostream>
+#if defined __linux__
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#elif defined __APPLE__
+#include <pthread.h>
+#endif
+#include "IrisCore.hpp"
 #include "IrisTypes.hpp"
 #include "IrisQueue.hpp"
 #include "IrisAsync.hpp"
@@ -18,22 +30,519 @@ ThreadPool createThreadPool (uint32_t thread_pool_size)
 {
     return std::make_shared<__INTERNAL__Pool>(thread_pool_size);
 }
+ThreadPool createThreadPool (const ThreadPoolCreateInfo& info)
+{
+    return std::make_shared<__INTERNAL__Pool>(info);
+}
+CpuSet getAvailableCpus ()
+{
+    CpuSet cpus;
+    #if defined __linux__
+    cpu_set_t mask;
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+        for (uint32_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+    #endif
+    return cpus;
+}
+CancelToken createCancelToken ()
+{
+    return std::make_shared<__INTERNAL__CancelToken>();
+}
+Fence createFence ()
+{
+    return std::allocate_shared<__INTERNAL__Fence>(__INTERNAL__RecyclingAllocator<__INTERNAL__Fence>());
+}
+namespace {
+// Pin the calling thread to the CPUs of a NUMA node listed in
+// sysfs as a range list (ex: "0-15,32-47").
+void PIN_TO_NUMA_NODE (uint16_t node)
+{
+    #if defined __linux__
+    char path [64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+    FILE* list = fopen(path, "r");
+    if (list == nullptr) return;
+    
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    unsigned first = 0, last = 0;
+    for (int read; (read = fscanf(list, "%u-%u", &first, &last)) > 0;) {
+        if (read == 1) last = first;
+        for (unsigned cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu)
+            CPU_SET(cpu, &cpus);
+        if (fgetc(list) != ',') break;
+    } fclose(list);
+    
+    if (CPU_COUNT(&cpus))
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    #endif
+}
+// Apply the name, CPU set and niceness requested for a worker to the calling thread.
+void CONFIGURE_WORKER_THREAD (const ThreadPoolCreateInfo& info, uint32_t index)
+{
+    if (!info.name.empty()) {
+        // Thread names are limited to 16 bytes including the terminator;
+        // keep the index, which distinguishes workers, over the prefix.
+        auto suffix = "-" + std::to_string(index);
+        auto name   = info.name.substr(0, 15 - std::min<size_t>(suffix.size(), 15)) + suffix;
+        name.resize(std::min<size_t>(name.size(), 15));
+        #if defined __linux__
+        pthread_setname_np(pthread_self(), name.c_str());
+        #elif defined __APPLE__
+        pthread_setname_np(name.c_str());
+        #endif
+    }
+    #if defined __linux__
+    if (!info.workerCpuSets.empty()) {
+        auto& set = info.workerCpuSets[index % info.workerCpuSets.size()];
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (auto cpu : set)
+            if (cpu < CPU_SETSIZE) CPU_SET(cpu, &cpus);
+        if (CPU_COUNT(&cpus) && pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus))
+            std::cerr   << "[WARNING] Iris Async Pool: Failed to set the CPU set of worker "
+                        << index << "\n";
+    }
+    // Linux applies the niceness of a thread ID to that thread alone.
+    if (info.niceness && setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), info.niceness))
+        std::cerr   << "[WARNING] Iris Async Pool: Failed to set the niceness of worker "
+                    << index << " to " << info.niceness << "\n";
+    #endif
+}
+// The pool and worker index of the calling thread, if it is a pool worker.
+thread_local const __INTERNAL__Pool*    CURRENT_POOL    = nullptr;
+thread_local uint32_t                   CURRENT_WORKER  = 0;
+// Hint to the processor that the thread is spin-waiting
+inline void CPU_RELAX ()
+{
+    #if defined _WIN32
+    YieldProcessor();
+    #elif defined __x86_64__ || defined __i386__
+    __builtin_ia32_pause();
+    #elif defined __aarch64__ || defined __arm__
+    __asm__ __volatile__ ("yield");
+    #endif
+}
+// Invoke an action once every fence has been signalled, from the thread that
+// signals the last of them. The count starts one high so the action cannot
+// run until every continuation has been registered.
+void ON_ALL_SIGNALED (const std::vector<Fence>& fences, LambdaPtr action)
+{
+    struct __JOIN {
+        atomic_uint32   remaining;
+        LambdaPtr       action;
+    };
+    auto join = std::make_shared<__JOIN>();
+    join->remaining = static_cast<uint32_t>(fences.size()) + 1;
+    join->action    = std::move(action);
+    LambdaPtr arrive = [join] {
+        if (join->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            LambdaPtr action = std::move(join->action);
+            action();
+        }
+    };
+    for (auto& fence : fences)
+        if (!fence || !fence->add_continuation(arrive))
+            arrive();
+    arrive();
+}
+// Notified whenever any fence is signalled, for waits upon several fences.
+// Free to notify while no thread is waiting upon it.
+__INTERNAL__EventCount FENCE_SIGNALS;
+// Sleep on FENCE_SIGNALS until the condition holds or the deadline passes.
+// Returns the final evaluation of the condition.
+template <class Condition>
+bool WAIT_FOR_FENCES (TimePoint deadline, Condition&& condition)
+{
+    while (!condition()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) return false;
+        const uint32_t key = FENCE_SIGNALS.prepare_wait();
+        if (condition()) {
+            FENCE_SIGNALS.cancel_wait();
+            return true;
+        }
+        if (deadline == TimePoint::max()) FENCE_SIGNALS.wait(key);
+        else FENCE_SIGNALS.wait_for(key, deadline - now);
+    } return true;
+}
+// Victim selection for work stealing (xorshift; quality is unimportant)
+inline uint32_t RANDOM_VICTIM (uint32_t workers)
+{
+    thread_local uint32_t state = 0x9E3779B9U ^ CURRENT_WORKER;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state % workers;
+}
+} // END ANONYMOUS NAMESPACE
+void __INTERNAL__WorkerQueue::push (Callback&& callback)
+{
+    MutexLock queue_lock (lock);
+    tasks.push_back(std::move(callback));
+}
+bool __INTERNAL__WorkerQueue::pop_back (Callback& callback)
+{
+    MutexLock queue_lock (lock);
+    if (tasks.empty()) return false;
+    callback = std::move(tasks.back());
+    tasks.pop_back();
+    return true;
+}
+bool __INTERNAL__WorkerQueue::pop_front (Callback& callback)
+{
+    MutexLock queue_lock (lock);
+    if (tasks.empty()) return false;
+    callback = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+}
+bool __INTERNAL__WorkerQueue::steal_front (Callback& callback)
+{
+    MutexLock queue_lock (lock, std::try_to_lock);
+    if (!queue_lock.owns_lock() || tasks.empty()) return false;
+    callback = std::move(tasks.front());
+    tasks.pop_front();
+    return true;
+}
+uint64_t __INTERNAL__TimerWheel::tick (TimePoint time) const
+{
+    constexpr uint64_t resolution = IRIS_ASYNC_TIMER_RESOLUTION_US * 1000ULL;
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch).count();
+    return elapsed > 0 ? static_cast<uint64_t>(elapsed) / resolution : 0;
+}
+TimePoint __INTERNAL__TimerWheel::deadline (uint64_t tick) const
+{
+    return epoch + std::chrono::microseconds(tick * IRIS_ASYNC_TIMER_RESOLUTION_US);
+}
+bool __INTERNAL__TimerWheel::add (TimePoint deadline, Callback&& task)
+{
+    // Round the deadline up to a whole tick so the timer never fires early,
+    // and place overdue timers in the next tick to be advanced through.
+    uint64_t timer_tick = tick(deadline);
+    if (this->deadline(timer_tick) < deadline) timer_tick++;
+    
+    MutexLock timer_lock (lock);
+    timer_tick = std::max(timer_tick, current + 1);
+    slots[timer_tick % IRIS_ASYNC_TIMER_SLOTS].push_back(Timer {timer_tick, std::move(task)});
+    count++;
+    if (timer_tick >= next.load()) return false;
+    next.store(timer_tick);
+    return true;
+}
+void __INTERNAL__TimerWheel::advance (TimePoint now, std::vector<Callback>& expired)
+{
+    const uint64_t now_tick = tick(now);
+    MutexLock timer_lock (lock);
+    if (now_tick <= current) return;
+    
+    // Visit the slot of each elapsed tick (every slot, at most, once).
+    const uint64_t steps = std::min<uint64_t>(now_tick - current, IRIS_ASYNC_TIMER_SLOTS);
+    for (uint64_t step = 1; step <= steps; ++step) {
+        auto& slot = slots[(current + step) % IRIS_ASYNC_TIMER_SLOTS];
+        for (size_t index = 0; index < slot.size();) {
+            if (slot[index].tick > now_tick) { ++index; continue; }
+            expired.push_back(std::move(slot[index].task));
+            if (index + 1 < slot.size()) slot[index] = std::move(slot.back());
+            slot.pop_back();
+            count--;
+        }
+    }
+    current = now_tick;
+    
+    // Find the earliest remaining timer. Timers in the slot 'step' ticks
+    // ahead are due no sooner than that tick, so the search stops at the
+    // first slot holding a timer due within the coming revolution.
+    uint64_t earliest = UINT64_MAX;
+    for (uint64_t step = 1; count && step <= IRIS_ASYNC_TIMER_SLOTS; ++step) {
+        for (auto& timer : slots[(current + step) % IRIS_ASYNC_TIMER_SLOTS])
+            earliest = std::min(earliest, timer.tick);
+        if (earliest <= current + step) break;
+    }
+    next.store(earliest);
+}
+void __INTERNAL__TimerWheel::clear ()
+{
+    // Release the tasks' captured state outside of the lock,
+    // in case releasing it schedules another timer.
+    std::vector<Timer> discarded;
+    {   MutexLock timer_lock (lock);
+        for (auto& slot : slots) {
+            for (auto& timer : slot)
+                discarded.push_back(std::move(timer));
+            slot.clear();
+        }
+        count = 0;
+        next.store(UINT64_MAX);
+    }
+}
 
 void __INTERNAL__Fence::wait_on_signal () {
     complete.wait(false);
 }
+void __INTERNAL__Fence::signal () {
+    LambdaPtrs callbacks;
+    {   // Completion and continuation registration are serialized so
+        // a continuation is either invoked here or refused by add_continuation.
+        MutexLock continuation_lock (continuationLock);
+        complete = true;
+        callbacks.swap(continuations);
+    }
+    complete.notify_all();
+    FENCE_SIGNALS.notify_all();
+    for (auto& callback : callbacks)
+        callback();
+}
+void __INTERNAL__Fence::arrive () {
+    if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        signal();
+}
+bool __INTERNAL__Fence::add_continuation (const LambdaPtr& callback) {
+    MutexLock continuation_lock (continuationLock);
+    if (complete) return false;
+    continuations.push_back(callback);
+    return true;
+}
+bool __INTERNAL__Fence::wait_until (TimePoint deadline) {
+    return complete || WAIT_FOR_FENCES(deadline, [this] { return complete.load(); });
+}
+bool wait_all (const std::vector<Fence>& fences, TimePoint deadline)
+{
+    size_t signalled = 0;   // Fences before this index are signalled
+    return WAIT_FOR_FENCES(deadline, [&] {
+        while (signalled < fences.size() &&
+               (!fences[signalled] || fences[signalled]->complete)) ++signalled;
+        return signalled == fences.size();
+    });
+}
+size_t wait_any (const std::vector<Fence>& fences, TimePoint deadline)
+{
+    size_t index = fences.size();
+    WAIT_FOR_FENCES(deadline, [&] {
+        for (index = 0; index < fences.size(); ++index)
+            if (!fences[index] || fences[index]->complete) return true;
+        return false;
+    }); return index;
+}
+Fence createJoinFence (const std::vector<Fence>& fences)
+{
+    auto join = createFence();
+    ON_ALL_SIGNALED(fences, [join] {
+        join->signal();
+    });
+    return join;
+}
+TaskGraph::Node TaskGraph::add_task (const LambdaPtr& task, std::initializer_list<Node> dependencies, TaskPriority priority)
+{
+    const Node node = static_cast<Node>(_tasks.size());
+    for (auto dependency : dependencies)
+        if (dependency >= node) throw std::runtime_error
+            ("TaskGraph tasks may only depend upon previously added tasks");
+    _tasks.push_back(__Task {
+        .task           = task,
+        .priority       = priority,
+        .dependencies   = dependencies,
+    });
+    return node;
+}
+void TaskGraph::add_dependency (Node before, Node after)
+{
+    if (before >= after || after >= _tasks.size()) throw std::runtime_error
+        ("TaskGraph tasks may only depend upon previously added tasks");
+    _tasks[after].dependencies.push_back(before);
+}
+size_t TaskGraph::size () const
+{
+    return _tasks.size();
+}
+const std::vector<TaskGraph::__Task>& TaskGraph::tasks () const
+{
+    return _tasks;
+}
+uint32_t LatencyHistogram::bucket (uint64_t nanoseconds)
+{
+    // The leading bit selects the power-of-two range and the following
+    // precision bits select the linear sub-bucket within that range.
+    constexpr uint32_t PRECISION = IRIS_LATENCY_PRECISION_BITS;
+    const uint32_t width = std::bit_width(nanoseconds);
+    if (width <= PRECISION) return static_cast<uint32_t>(nanoseconds);
+    const uint32_t shift = width - PRECISION - 1;
+    const uint32_t index = ((shift + 1) << PRECISION) +
+    static_cast<uint32_t>((nanoseconds >> shift) & ((1ULL << PRECISION) - 1));
+    return index < IRIS_LATENCY_BUCKETS ? index : IRIS_LATENCY_BUCKETS - 1;
+}
+uint64_t LatencyHistogram::upper_bound (uint32_t bucket)
+{
+    constexpr uint32_t PRECISION = IRIS_LATENCY_PRECISION_BITS;
+    const uint32_t range = bucket >> PRECISION;
+    const uint64_t step  = bucket & ((1U << PRECISION) - 1);
+    if (range == 0) return step + 1;
+    return ((1ULL << PRECISION) + step + 1) << (range - 1);
+}
+void LatencyHistogram::merge (const LatencyHistogram& histogram)
+{
+    for (uint32_t bucket = 0; bucket < IRIS_LATENCY_BUCKETS; ++bucket)
+        buckets[bucket] += histogram.buckets[bucket];
+    samples += histogram.samples;
+}
+void __INTERNAL__LatencyHistogram::record (std::chrono::nanoseconds latency)
+{
+    const uint64_t nanoseconds = latency.count() > 0 ? latency.count() : 0;
+    buckets[LatencyHistogram::bucket(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+}
+void __INTERNAL__LatencyHistogram::sample_into (LatencyHistogram& histogram) const
+{
+    for (uint32_t bucket = 0; bucket < IRIS_LATENCY_BUCKETS; ++bucket) {
+        const uint64_t count = buckets[bucket].load(std::memory_order_relaxed);
+        histogram.buckets[bucket]  += count;
+        histogram.samples          += count;
+    }
+}
+uint64_t LatencyHistogram::quantile (double quantile) const
+{
+    if (samples == 0) return 0;
+    const double target = quantile * static_cast<double>(samples);
+    uint64_t cumulative = 0;
+    for (uint32_t bucket = 0; bucket < IRIS_LATENCY_BUCKETS; ++bucket) {
+        cumulative += buckets[bucket];
+        if (cumulative && static_cast<double>(cumulative) >= target)
+            return upper_bound(bucket);
+    } return upper_bound(IRIS_LATENCY_BUCKETS - 1);
+}
+double WorkerStatistics::busy_ratio () const
+{
+    return aliveNanoseconds ? static_cast<double>(busyNanoseconds) / aliveNanoseconds : 0.0;
+}
+void __INTERNAL__WorkerStatistics::sample_into (WorkerStatistics& statistics) const
+{
+    statistics.tasks            = tasks.load(std::memory_order_relaxed);
+    statistics.steals           = steals.load(std::memory_order_relaxed);
+    statistics.parks            = parks.load(std::memory_order_relaxed);
+    statistics.busyNanoseconds  = busy.load(std::memory_order_relaxed);
+    statistics.aliveNanoseconds = alive.load(std::memory_order_relaxed);
+    if (auto start = started.load(std::memory_order_relaxed)) {
+        const int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+        if (now > start) statistics.aliveNanoseconds += now - start;
+    }
+}
+uint32_t __INTERNAL__EventCount::prepare_wait ()
+{
+    // Register as a waiter before the caller re-checks its wake condition
+    // (pairs with the fence in notify) so either the waker sees the waiter
+    // or the waiter sees whatever the waker published.
+    _waiters.fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return _epoch.load(std::memory_order_acquire);
+}
+void __INTERNAL__EventCount::cancel_wait ()
+{
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+void __INTERNAL__EventCount::wait (uint32_t key)
+{
+    MutexLock wait_lock (_mtx);
+    _cv.wait(wait_lock, [this, key] {
+        return _epoch.load(std::memory_order_acquire) != key;
+    });
+    wait_lock.unlock();
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+bool __INTERNAL__EventCount::wait_for (uint32_t key, std::chrono::nanoseconds timeout)
+{
+    MutexLock wait_lock (_mtx);
+    const bool notified = _cv.wait_for(wait_lock, timeout, [this, key] {
+        return _epoch.load(std::memory_order_acquire) != key;
+    });
+    wait_lock.unlock();
+    _waiters.fetch_sub(1, std::memory_order_relaxed);
+    return notified;
+}
+void __INTERNAL__EventCount::notify_one ()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiters.load(std::memory_order_relaxed) == 0) return;
+    
+    // Advancing the epoch under the mutex ensures a waiter is either
+    // yet to check its key or is already blocked on the condition.
+    { MutexLock notify_lock (_mtx); _epoch.fetch_add(1, std::memory_order_release); }
+    _cv.notify_one();
+}
+void __INTERNAL__EventCount::notify_many (size_t count)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint32_t waiters = _waiters.load(std::memory_order_relaxed);
+    if (waiters == 0 || count == 0) return;
+    
+    // One epoch advance covers every waiter woken by this notification
+    { MutexLock notify_lock (_mtx); _epoch.fetch_add(1, std::memory_order_release); }
+    if (count >= waiters) return _cv.notify_all();
+    for (size_t index = 0; index < count; ++index)
+        _cv.notify_one();
+}
+void __INTERNAL__EventCount::notify_all ()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_waiters.load(std::memory_order_relaxed) == 0) return;
+    { MutexLock notify_lock (_mtx); _epoch.fetch_add(1, std::memory_order_release); }
+    _cv.notify_all();
+}
 
 __INTERNAL__Pool::__INTERNAL__Pool (uint32_t thread_pool_size) :
-_threads    (thread_pool_size),
+__INTERNAL__Pool (ThreadPoolCreateInfo {
+    .threads        = thread_pool_size,
+})
+{
+    
+}
+__INTERNAL__Pool::__INTERNAL__Pool (const ThreadPoolCreateInfo& info) :
+_info       (info),
+_threads    (info.threads),
+_states     (info.threads),
+_nodes      (info.threads, IRIS_NUMA_NODE_ANY),
+_live       (info.threads, 0),
+_workers    (0),
+_blocked    (0),
+_link       (std::make_shared<__INTERNAL__PoolLink>()),
+_deferred   (0),
 _pending    (0),
+_cancelled  (0),
 status      (POOL_ACTIVE)
 {
-    // Start all of the callback threads
-    for (auto& thread : _threads)
-        thread = std::thread {
-            &__INTERNAL__Pool::process_tasks,
-            this
-        };
+    _link->pool = this;
+    
+    // Each worker records the latency of the tasks it starts
+    for (uint32_t index = 0; index < info.threads * TASK_PRIORITY_MAX_ENUM; ++index) {
+        _latency.push_back(std::make_unique<__INTERNAL__LatencyHistogram>());
+        _runtime.push_back(std::make_unique<__INTERNAL__LatencyHistogram>());
+    }
+    for (uint32_t index = 0; index < info.threads; ++index)
+        _statistics.push_back(std::make_unique<__INTERNAL__WorkerStatistics>());
+    
+    // Work-stealing pools give each worker a local deque
+    if (info.workStealing)
+        for (uint32_t index = 0; index < info.threads; ++index)
+            _locals.push_back(std::make_unique<__INTERNAL__WorkerQueue>());
+    
+    // Divide the workers into contiguous, evenly sized node groups
+    const uint32_t nodes = Get_numa_node_count();
+    if (info.numaNodeGroups && nodes > 1)
+        for (uint32_t index = 0; index < _nodes.size(); ++index)
+            _nodes[index] = static_cast<uint16_t>(index * nodes / _nodes.size());
+    
+    // Fixed size grouped pools accept tasks for a node's group. Elastic
+    // pools do not, as a group's workers may all retire.
+    if (info.numaNodeGroups && nodes > 1 && !info.elastic) {
+        for (uint16_t node = 0; node < nodes; ++node)
+            _node_queues.push_back(std::make_unique<__INTERNAL__NodeQueue>());
+        for (auto node : _nodes)
+            _node_queues[node]->workers++;
+    }
+    
+    // Start all of the callback threads (or the minimum, if elastic)
+    start_workers(info.elastic ?
+                  std::clamp<uint32_t>(info.minimumThreads, 1, info.threads) :
+                  info.threads);
 }
 __INTERNAL__Pool::~__INTERNAL__Pool ()
 {
@@ -47,127 +556,782 @@ inline void WARN_INACTIVE_QUEUE()
 size_t __INTERNAL__Pool::pending_tasks() const {
     return _pending.load();
 }
-void __INTERNAL__Pool::issue_task(const LambdaPtr &lambda)
+uint32_t __INTERNAL__Pool::thread_count() const {
+    return static_cast<uint32_t>(_threads.size());
+}
+uint32_t __INTERNAL__Pool::active_threads() const {
+    return _workers.load();
+}
+void __INTERNAL__Pool::begin_blocking() {
+    _blocked.fetch_add(1);
+    grow();
+}
+void __INTERNAL__Pool::end_blocking() {
+    auto blocked = _blocked.load();
+    while (!_blocked.compare_exchange_weak(blocked, blocked?blocked-1:0));
+}
+size_t __INTERNAL__Pool::cancelled_tasks() const {
+    return _cancelled.load();
+}
+uint16_t __INTERNAL__Pool::worker_numa_node(uint32_t worker_index) const {
+    return worker_index < _nodes.size() ? _nodes[worker_index] : IRIS_NUMA_NODE_ANY;
+}
+PoolStatistics __INTERNAL__Pool::get_statistics() const {
+    PoolStatistics statistics;
+    statistics.pendingTasks     = _pending.load();
+    statistics.cancelledTasks   = _cancelled.load();
+    statistics.instrumented     = _info.instrumentation;
+    for (size_t index = 0; index < _latency.size(); ++index) {
+        _latency[index]->sample_into(statistics.waitLatency[index % TASK_PRIORITY_MAX_ENUM]);
+        _runtime[index]->sample_into(statistics.runLatency[index % TASK_PRIORITY_MAX_ENUM]);
+    }
+    statistics.workers.resize(_statistics.size());
+    for (size_t index = 0; index < _statistics.size(); ++index)
+        _statistics[index]->sample_into(statistics.workers[index]);
+    return statistics;
+}
+LatencyHistogram __INTERNAL__Pool::get_wake_latency_histogram() const {
+    LatencyHistogram histogram;
+    for (auto& latency : _latency)
+        latency->sample_into(histogram);
+    return histogram;
+}
+LatencyHistogram __INTERNAL__Pool::get_wake_latency_histogram(TaskPriority priority) const {
+    LatencyHistogram histogram;
+    for (size_t index = priority; index < _latency.size(); index += TASK_PRIORITY_MAX_ENUM)
+        _latency[index]->sample_into(histogram);
+    return histogram;
+}
+bool __INTERNAL__Pool::issue_task(InlineLambda lambda, TaskPriority priority, const CancelToken& token)
 {
     // Return if the pool is not active / Shutting down
-    if (status & POOL_TERMINATING) return WARN_INACTIVE_QUEUE();
+    if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return false; }
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
     
     // Insert the task into the list.
-    _tasks.push(Callback{
-        .callback       = lambda,
+    _pending++;
+    push_task(Callback{
+        .callback       = std::move(lambda),
         .fenceOptional  = nullptr,
+        .cancelOptional = token,
+        .issued         = std::chrono::steady_clock::now(),
+        .priority       = priority,
     });
-    _pending++;
     
-    // And notify any waiting implementation threads
-    _task_added.notify_one();
+    // And wake an idle implementation thread
+    _idle.notify_one();
+    grow();
+    return true;
 }
-Fence __INTERNAL__Pool::issue_task_with_fence(const LambdaPtr &lambda)
+Fence __INTERNAL__Pool::issue_task_with_fence(InlineLambda lambda, TaskPriority priority, const CancelToken& token)
 {
+    // Create a callback fence
+    auto fence = createFence();
+    if (!issue_with_fence(std::move(lambda), fence, priority, token)) return NULL;
+    return fence;
+}
+Fence __INTERNAL__Pool::issue_task_on_node(uint16_t numa_node, InlineLambda lambda, const CancelToken& token)
+{
+    // Without a group on the node, any worker may run the task.
+    if (numa_node >= _node_queues.size() || _node_queues[numa_node]->workers == 0)
+        return issue_task_with_fence(std::move(lambda), TASK_PRIORITY_NORMAL, token);
+    
     // Return if the pool is not active / Shutting down
     if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return NULL; }
     
-    // Create a callback fence
-    auto fence = std::make_shared<__INTERNAL__Fence>();
+    auto  fence = createFence();
+    auto& queue = *_node_queues[numa_node];
+    _pending++;
+    queue.queued.fetch_add(1);
+    queue.tasks.push(Callback{
+        .callback       = std::move(lambda),
+        .fenceOptional  = fence,
+        .cancelOptional = token,
+        .issued         = std::chrono::steady_clock::now(),
+        .priority       = TASK_PRIORITY_NORMAL,
+    });
+    
+    // Parked workers cannot be woken by group, so wake them all if one of
+    // the group is parked. Otherwise a running worker of the group takes
+    // the task; one about to park re-checks the queue after counting itself.
+    if (queue.parked.load()) _idle.notify_all();
+    return fence;
+}
+bool __INTERNAL__Pool::issue_with_fence(InlineLambda&& lambda, const Fence& fence,
+                                        TaskPriority priority, const CancelToken& token)
+{
+    // Return if the pool is not active / Shutting down
+    if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return false; }
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
     
     // Insert the task into the list.
-    _tasks.push(Callback{
-        .callback       = lambda,
+    _pending++;
+    push_task(Callback{
+        .callback       = std::move(lambda),
         .fenceOptional  = fence,
+        .cancelOptional = token,
+        .issued         = std::chrono::steady_clock::now(),
+        .priority       = priority,
     });
-    _pending++;
     
-    // And notify any waiting implementation threads
-    _task_added.notify_one();
+    // And wake an idle implementation thread
+    _idle.notify_one();
+    grow();
+    
+    return true;
+}
+void __INTERNAL__Pool::issue_tasks(std::span<const LambdaPtr> lambdas, TaskPriority priority, const CancelToken& token)
+{
+    // Return if the pool is not active / Shutting down
+    if (status & POOL_TERMINATING) return WARN_INACTIVE_QUEUE();
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
+    
+    issue_batch(lambdas, priority, token, nullptr);
+}
+Fence __INTERNAL__Pool::issue_tasks_with_fence(std::span<const LambdaPtr> lambdas, TaskPriority priority, const CancelToken& token)
+{
+    // Return if the pool is not active / Shutting down
+    if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return NULL; }
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
+    
+    // Create the aggregate fence. An empty batch is already complete.
+    auto fence = createFence();
+    fence->outstanding = lambdas.size();
+    if (lambdas.empty()) fence->signal();
     
+    issue_batch(lambdas, priority, token, fence);
     return fence;
 }
+void __INTERNAL__Pool::issue_batch(std::span<const LambdaPtr> lambdas, TaskPriority priority,
+                                   const CancelToken& token, const Fence& fence)
+{
+    if (lambdas.empty()) return;
+    
+    const auto issued = std::chrono::steady_clock::now();
+    std::vector<Callback> callbacks;
+    callbacks.reserve(lambdas.size());
+    for (auto& lambda : lambdas)
+        callbacks.push_back(Callback {
+            .callback       = lambda,
+            .fenceOptional  = fence,
+            .cancelOptional = token,
+            .issued         = issued,
+            .priority       = priority,
+        });
+    
+    // Insert the tasks into the list and wake
+    // up to one idle implementation thread per task.
+    _pending += callbacks.size();
+    push_tasks(callbacks);
+    _idle.notify_many(callbacks.size());
+    grow();
+}
+Fence __INTERNAL__Pool::issue_task_after(const std::vector<Fence>& predecessors, InlineLambda lambda,
+                                         TaskPriority priority, const CancelToken& token)
+{
+    // Create a callback fence
+    auto fence = createFence();
+    if (!issue_after(predecessors, std::move(lambda), fence, priority, token)) return NULL;
+    return fence;
+}
+bool __INTERNAL__Pool::issue_after(const std::vector<Fence>& predecessors, InlineLambda&& lambda,
+                                   const Fence& fence, TaskPriority priority, const CancelToken& token)
+{
+    // Return if the pool is not active / Shutting down
+    if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return false; }
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
+    
+    // The task is pending from now but only enters the queue when the final
+    // predecessor is signalled. (Shared, as continuations must be copyable.)
+    // The continuation reaches the pool through its link, as the pool may
+    // since have shut down or been destroyed.
+    _pending++;
+    _deferred++;
+    ON_ALL_SIGNALED(predecessors, [link = _link, callback = std::make_shared<Callback>(Callback {
+        .callback       = std::move(lambda),
+        .fenceOptional  = fence,
+        .cancelOptional = token,
+        .priority       = priority,
+    })] {
+        MutexLock link_lock (link->lock);
+        if (auto pool = link->pool; pool && !(pool->status & POOL_TERMINATING)) {
+            callback->issued = std::chrono::steady_clock::now();
+            pool->push_task(std::move(*callback));
+            // Draining workers wait on the final deferred task; release them all.
+            if (pool->_deferred.fetch_sub(1) == 1 && (pool->status & POOL_DRAINING))
+                pool->_idle.notify_all();
+            else pool->_idle.notify_one();
+            pool->grow();
+            return;
+        } else if (pool) {
+            pool->_deferred--;
+            pool->_pending--;
+        }
+        link_lock.unlock();
+        
+        // The pool will not run the task: withdraw it and release any waiters.
+        auto fence = std::move(callback->fenceOptional);
+        callback->callback = nullptr;
+        if (fence) {
+            fence->cancelled = true;
+            fence->arrive();
+        }
+    });
+    
+    return true;
+}
+Fence __INTERNAL__Pool::issue_task_graph(const TaskGraph& graph, const CancelToken& token)
+{
+    // Graph nodes only reference earlier nodes, so every
+    // predecessor fence exists by the time it is needed.
+    std::vector<Fence> fences;
+    fences.reserve(graph.size());
+    for (auto& node : graph.tasks()) {
+        if (node.dependencies.empty()) {
+            fences.push_back(issue_task_with_fence(node.task, node.priority, token));
+            continue;
+        }
+        std::vector<Fence> predecessors;
+        predecessors.reserve(node.dependencies.size());
+        for (auto dependency : node.dependencies)
+            predecessors.push_back(fences[dependency]);
+        fences.push_back(issue_task_after(predecessors, node.task, node.priority, token));
+    }
+    return createJoinFence(fences);
+}
+CancelToken __INTERNAL__Pool::schedule_after(std::chrono::nanoseconds delay, InlineLambda lambda,
+                                             TaskPriority priority, const CancelToken& token)
+{
+    // Return if the pool is not active / Shutting down
+    if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return NULL; }
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
+    
+    // The token withdraws the task through the usual cancellation check.
+    auto cancel = token ? token : createCancelToken();
+    add_timer(std::chrono::steady_clock::now() + delay, Callback {
+        .callback       = std::move(lambda),
+        .cancelOptional = cancel,
+        .priority       = priority,
+    });
+    return cancel;
+}
+CancelToken __INTERNAL__Pool::schedule_every(std::chrono::nanoseconds period, LambdaPtr lambda,
+                                             TaskPriority priority, const CancelToken& token)
+{
+    // Return if the pool is not active / Shutting down
+    if (status & POOL_TERMINATING) { WARN_INACTIVE_QUEUE(); return NULL; }
+    if (priority >= TASK_PRIORITY_MAX_ENUM) priority = TASK_PRIORITY_NORMAL;
+    
+    // Periods shorter than a tick would fire every tick regardless.
+    period = std::max<std::chrono::nanoseconds>
+    (period, std::chrono::microseconds(IRIS_ASYNC_TIMER_RESOLUTION_US));
+    auto cancel = token ? token : createCancelToken();
+    schedule_periodic(std::chrono::steady_clock::now() + period, period,
+                      std::move(lambda), priority, cancel);
+    return cancel;
+}
+void __INTERNAL__Pool::schedule_periodic(TimePoint deadline, std::chrono::nanoseconds period,
+                                         LambdaPtr lambda, TaskPriority priority, const CancelToken& token)
+{
+    // Each run schedules the next once it returns (not if it throws or was
+    // cancelled). An overrun run is followed at once by the next, rather
+    // than by a run for every period missed.
+    add_timer(deadline, Callback {
+        .callback       = [this, deadline, period, lambda, priority, token] {
+            lambda();
+            schedule_periodic(std::max(deadline + period, std::chrono::steady_clock::now()),
+                              period, lambda, priority, token);
+        },
+        .cancelOptional = token,
+        .priority       = priority,
+    });
+}
+void __INTERNAL__Pool::add_timer(TimePoint deadline, Callback&& timer)
+{
+    // A new earliest timer wakes the parked workers so that the time
+    // keeper, or a worker that parked while no timer was set, re-arms.
+    if (_timers.add(deadline, std::move(timer)))
+        _idle.notify_all();
+}
+void __INTERNAL__Pool::fire_timers()
+{
+    // No clock read unless a timer is set
+    const uint64_t next = _timers.next.load(std::memory_order_relaxed);
+    if (next == UINT64_MAX) return;
+    const auto now = std::chrono::steady_clock::now();
+    if (_timers.tick(now) < next) return;
+    
+    // Issue the expired timers as tasks, waking a worker for each.
+    std::vector<Callback> expired;
+    _timers.advance(now, expired);
+    if (expired.empty()) return;
+    _pending += expired.size();
+    for (auto& timer : expired) {
+        timer.issued = now;
+        push_task(std::move(timer));
+    }
+    _idle.notify_many(expired.size());
+    grow();
+}
+void __INTERNAL__Pool::push_task(Callback&& callback)
+{
+    // Workers of a work-stealing pool keep the normal priority tasks they
+    // issue local; everything else is injected through the priority lanes.
+    const auto priority = callback.priority;
+    if (_locals.size() && CURRENT_POOL == this && priority == TASK_PRIORITY_NORMAL)
+        _locals[CURRENT_WORKER]->push(std::move(callback));
+    else _tasks[priority].push(std::move(callback));
+}
+void __INTERNAL__Pool::push_tasks(std::vector<Callback>& callbacks)
+{
+    // As with push_task, but the batch is pushed under one lock or one reservation per queue node.
+    if (_locals.size() && CURRENT_POOL == this && callbacks.front().priority == TASK_PRIORITY_NORMAL) {
+        auto& local = *_locals[CURRENT_WORKER];
+        MutexLock queue_lock (local.lock);
+        for (auto& callback : callbacks)
+            local.tasks.push_back(std::move(callback));
+    } else _tasks[callbacks.front().priority].push(callbacks.data(), callbacks.size());
+}
+bool __INTERNAL__Pool::next_task(__INTERNAL__WorkerState& worker, Callback& callback)
+{
+    // 0) Starvation guard: periodically serve background work first
+    if (++worker.selections % IRIS_ASYNC_STARVATION_INTERVAL == 0 &&
+        pop_lane(worker, TASK_PRIORITY_BACKGROUND, callback)) return true;
+    
+    // 1) Interactive tasks
+    if (pop_lane(worker, TASK_PRIORITY_INTERACTIVE, callback)) return true;
+    
+    // 1b) Tasks issued to the worker's node group
+    if (_node_queues.size()) {
+        auto& queue = *_node_queues[_nodes[worker.index]];
+        if (queue.queued.load() && queue.tasks.pop_front(callback)) {
+            queue.queued.fetch_sub(1);
+            return true;
+        }
+    }
+    
+    // 2) Most recently issued local task (likely still in cache)
+    if (_locals.size() && _locals[worker.index]->pop_back(callback)) return true;
+    
+    // 3) Normal priority (externally injected) tasks
+    if (pop_lane(worker, TASK_PRIORITY_NORMAL, callback)) return true;
+    
+    // 4) Oldest task of another worker, starting at a random victim.
+    const uint32_t workers = static_cast<uint32_t>(_locals.size());
+    const uint32_t first   = workers ? RANDOM_VICTIM(workers) : 0;
+    for (uint32_t offset = 0; offset < workers; ++offset) {
+        uint32_t victim = (first + offset) % workers;
+        if (victim != worker.index && _locals[victim]->steal_front(callback)) {
+            __INTERNAL__WorkerStatistics::add(_statistics[worker.index]->steals, 1);
+            return true;
+        }
+    }
+    
+    // 5) Background tasks
+    return pop_lane(worker, TASK_PRIORITY_BACKGROUND, callback);
+}
+bool __INTERNAL__Pool::pop_lane(__INTERNAL__WorkerState& worker, TaskPriority lane, Callback& callback)
+{
+    // Elastic pools copy running workers' lanes to seed new workers (see start_worker).
+    if (!_info.elastic) return worker.lanes[lane].pop(callback);
+    MutexLock lanes_lock (worker.lanesLock);
+    return worker.lanes[lane].pop(callback);
+}
+__INTERNAL__Pool::ScheduleAwaiter __INTERNAL__Pool::schedule(TaskPriority priority)
+{
+    return ScheduleAwaiter {this, priority};
+}
+bool __INTERNAL__Pool::ScheduleAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    // Continue on the awaiting thread rather than strand the coroutine
+    // in a pool that will not run it. (The task may resume the coroutine
+    // before issue_task returns, so nothing of the awaiter is used after.)
+    return pool->issue_task([handle]{ handle.resume(); }, priority);
+}
 void __INTERNAL__Pool::wait_until_complete ()
 {
-    {// Switch the pool to the draining state
+    {// Switch the pool to the draining state (no workers spawn once set)
+        MutexLock elastic_lock (_elastic);
         auto STATUS = status.load();
         while(!status.compare_exchange_weak(STATUS, (__status)(STATUS|POOL_DRAINING)));
     }
-    _task_added.notify_all();                                   // Ensure all exit the wait.
+    _idle.notify_all();                                         // Ensure all exit the wait.
     for (auto& thread : _threads)                               // Iterate over each worker
         if (thread.joinable())                                  // Check if it is outstanding; if so...
             thread.join();                                      // Merge threads and wait for it to complete.
     status.store(POOL_INACTIVE);
+    unlink();                                                   // Withdraw the deferred tasks.
+    _timers.clear();                                            // Discard the timers yet to fire.
 }
 void __INTERNAL__Pool::terminate()
 {
     {   // Switch the pool to the terminated state
+        MutexLock elastic_lock (_elastic);
         auto STATUS = status.load();
         while(!status.compare_exchange_weak(STATUS, (__status)(STATUS|POOL_TERMINATING)));
     }
-    _task_added.notify_all();                                   // Ensure all exit the wait.
+    _idle.notify_all();                                         // Ensure all exit the wait.
     for (auto& thread : _threads)                               // Iterate over each worker
         if (thread.joinable())                                  // Check if it is outstanding; if so...
             thread.join();                                      // Merge threads and wait for it to complete.
     status.store(POOL_INACTIVE);
+    unlink();                                                   // Withdraw the deferred tasks.
+    _timers.clear();                                            // Discard the timers yet to fire.
+}
+void __INTERNAL__Pool::unlink()
+{
+    // Deferred tasks released from now are withdrawn by their continuations
+    // (a drained pool's last worker may have unlinked it already).
+    MutexLock link_lock (_link->lock);
+    _link->pool = nullptr;
+    _pending -= _deferred.exchange(0);
 }
 void __INTERNAL__Pool::reset() {
     wait_until_complete();
+    MutexLock elastic_lock (_elastic);
+    _link = std::make_shared<__INTERNAL__PoolLink>();           // Tasks deferred before stay withdrawn
+    _link->pool = this;
     status.store(POOL_ACTIVE);
-    for (auto& thread : _threads)
-        thread = std::thread {
-            &__INTERNAL__Pool::process_tasks,
-            this
-        };
+    start_workers(_info.elastic ?
+                  std::clamp<uint32_t>(_info.minimumThreads, 1, _info.threads) :
+                  _info.threads);
+}
+void __INTERNAL__Pool::start_workers(uint32_t count) {
+    // Every worker has been joined; start the first count slots.
+    _workers.store(count);
+    for (uint32_t index = 0; index < _threads.size(); ++index) {
+        _live[index] = index < count;
+        if (_live[index]) start_worker(index);
+    }
+}
+void __INTERNAL__Pool::start_worker(uint32_t worker_index) {
+    // The lane iterators are taken before the thread starts. Queue nodes
+    // are only kept alive by iterators, so tasks issued before the thread
+    // begins would otherwise be released with their node, unexecuted.
+    // They begin at the tail, which is safe while other workers run.
+    FIFO2::Iterator<Callback> lanes [TASK_PRIORITY_MAX_ENUM] = {
+        _tasks[TASK_PRIORITY_INTERACTIVE].begin_at_tail(),
+        _tasks[TASK_PRIORITY_NORMAL].begin_at_tail(),
+        _tasks[TASK_PRIORITY_BACKGROUND].begin_at_tail(),
+    };
+    // Workers spawned by an elastic pool (with the elastic lock held) instead
+    // begin at the slowest running worker's position in each lane. Entries in
+    // earlier nodes, such as the backlog that called for the worker, are then
+    // reached by the new worker as well.
+    if (_info.elastic)
+        for (uint32_t index = 0; index < _states.size(); ++index) {
+            if (!_live[index] || index == worker_index || !_states[index]) continue;
+            auto& state = *_states[index];
+            MutexLock lanes_lock (state.lanesLock);
+            for (uint32_t lane = 0; lane < TASK_PRIORITY_MAX_ENUM; ++lane)
+                if (state.lanes[lane].precedes(lanes[lane]))
+                    lanes[lane] = state.lanes[lane];
+        }
+    auto& state = *(_states[worker_index] = std::unique_ptr<__INTERNAL__WorkerState>
+    (new __INTERNAL__WorkerState {
+        .index  = worker_index,
+        .lanes  = {
+            lanes[TASK_PRIORITY_INTERACTIVE],
+            lanes[TASK_PRIORITY_NORMAL],
+            lanes[TASK_PRIORITY_BACKGROUND],
+        },
+    }));
+    _threads[worker_index] = std::thread {
+        &__INTERNAL__Pool::process_tasks, this, std::ref(state)
+    };
+}
+void __INTERNAL__Pool::grow() {
+    // Elastic pools spawn a worker when more tasks are runnable (queued or
+    // running) than there are running workers free of blocking calls. Deferred
+    // tasks awaiting their predecessors are pending but not yet runnable.
+    if (!_info.elastic) return;
+    const uint32_t workers = _workers.load();
+    const uint32_t blocked = std::min(_blocked.load(), workers);
+    if (workers >= _threads.size() || runnable_tasks() <= workers - blocked) return;
+    
+    // Spawn as many as the backlog calls for (ex: after a batch is issued).
+    MutexLock elastic_lock (_elastic);
+    if (status != POOL_ACTIVE) return;
+    for (uint32_t index = 0; index < _live.size(); ++index) {
+        const uint32_t available = _workers.load() - std::min(_blocked.load(), _workers.load());
+        if (runnable_tasks() <= available) return;
+        if (_live[index]) continue;
+        
+        // Join the slot's retired worker, which has already left its loop.
+        if (_threads[index].joinable()) _threads[index].join();
+        _live[index] = 1;
+        _workers.fetch_add(1);
+        start_worker(index);
+    }
 }
-void __INTERNAL__Pool::process_tasks() {
+size_t __INTERNAL__Pool::runnable_tasks() const {
+    // Deferred tasks are counted as pending first and withdrawn from the
+    // deferred count first, so the deferred count is loaded first.
+    const size_t deferred   = _deferred.load();
+    const size_t pending    = _pending.load();
+    return pending > deferred ? pending - deferred : 0;
+}
+bool __INTERNAL__Pool::retire(__INTERNAL__WorkerState& worker) {
+    MutexLock elastic_lock (_elastic);
+    if (status != POOL_ACTIVE) return false;                    // Draining workers exit together
+    if (_workers.load() <= std::max(_info.minimumThreads, 1U)) return false;
+    _live[worker.index] = 0;
+    _workers.fetch_sub(1);
+    return true;
+}
+void __INTERNAL__Pool::process_tasks(__INTERNAL__WorkerState& worker) {
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
     //  HEADER BLOCK                                    //
     // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
-    using namespace FIFO2;
+    // Join the worker's node group, if grouped by node. Buffers
+    // it allocates with BUFFER_CREATE_NUMA_LOCAL reside on that node.
+    CURRENT_POOL    = this;
+    CURRENT_WORKER  = worker.index;
+    const uint16_t node = worker_numa_node(worker.index);
+    if (node != IRIS_NUMA_NODE_ANY) {
+        PIN_TO_NUMA_NODE        (node);
+        Set_thread_numa_node    (node);
+    }
+    CONFIGURE_WORKER_THREAD     (_info, worker.index);
+    auto& statistics = *_statistics[worker.index];
+    statistics.started.store(std::chrono::steady_clock::now().time_since_epoch().count());
+    
     Callback callback_entry;
-    Iterator<Callback> __it = _tasks.begin();
-    MutexLock task_lock     = MutexLock(_task_added_mtx, std::defer_lock);
-
-    while (status == POOL_ACTIVE) {
-        // Wait for a task to be issued.
-        try {
-            task_lock.lock();
-            _task_added.wait_for(task_lock, std::chrono::seconds(1)); // Check every second
-            task_lock.unlock();
-        } catch (...) {
-            if (task_lock.owns_lock())
-                task_lock.unlock();
-            task_lock = MutexLock(_task_added_mtx, std::defer_lock);
+    while (wait_for_task(worker, callback_entry))
+        execute_task(worker, callback_entry);
+    
+    // Fold this run into the worker's lifetime (a reset pool restarts it).
+    const auto elapsed = std::chrono::steady_clock::now().time_since_epoch().count()
+    - statistics.started.exchange(0);
+    __INTERNAL__WorkerStatistics::add(statistics.alive, elapsed > 0 ? elapsed : 0);
+    
+    // Release the state (and the queue nodes its lanes hold). The worker is no
+    // longer live, so new workers are no longer seeded from it.
+    _states[worker.index].reset();
+}
+bool __INTERNAL__Pool::wait_for_task(__INTERNAL__WorkerState& worker, Callback& callback)
+{
+    for (;;) {
+        if (status & POOL_TERMINATING) return false;
+        fire_timers();
+        if (next_task(worker, callback)) return true;
+        
+        // Draining pools exit once the queues are empty, unless tasks
+        // still running may yet release deferred tasks. The last worker
+        // out withdraws those remaining, so none is queued without a
+        // worker left to run it.
+        if ((status & POOL_DRAINING) && !awaiting_deferred()) {
+            MutexLock link_lock (_link->lock);
+            if (next_task(worker, callback)) return true;
+            if (_workers.fetch_sub(1) == 1) _link->pool = nullptr;
+            return false;
+        }
+        
+        // Spin briefly so a task issued shortly after starts without a wake-up.
+        // The queues are polled periodically to keep thieves off victims' locks.
+        for (uint32_t spin = 1; spin <= IRIS_ASYNC_SPIN_ITERATIONS; ++spin) {
+            CPU_RELAX();
+            if (spin % 64 == 0 && next_task(worker, callback))
+                return true;
+        }
+        
+        // Park until a task is issued or the pool state changes.
+        // The checks between prepare_wait and wait close the window
+        // in which a notification could otherwise be missed. Workers
+        // of a node group count themselves parked for node tasks.
+        struct __PARKED {
+            atomic_uint32*          count;
+           ~__PARKED                () { if (count) count->fetch_sub(1); }
+        } parked {_node_queues.size() ? &_node_queues[_nodes[worker.index]]->parked : nullptr};
+        if (parked.count) parked.count->fetch_add(1);
+        const uint32_t key = _idle.prepare_wait();
+        if (status != POOL_ACTIVE && !(status == POOL_DRAINING && awaiting_deferred())) {
+            _idle.cancel_wait();
             continue;
         }
+        if (next_task(worker, callback)) {
+            _idle.cancel_wait();
+            return true;
+        }
+        __INTERNAL__WorkerStatistics::add(_statistics[worker.index]->parks, 1);
         
-        // Attempt to implement those tasks.
-        try {
-            while (__it.pop(callback_entry) && (status ^ POOL_TERMINATING)) {
-                // Get the entry at the iterator's location.
+        // While timers are set, one parked worker keeps time for the pool,
+        // sleeping only until the earliest deadline. If woken for a task
+        // instead, it hands time keeping on to another parked worker.
+        const uint64_t timer = _timers.next.load();
+        if (timer != UINT64_MAX && !_timers.keeper.exchange(true)) {
+            const bool notified = _idle.wait_for
+            (key, _timers.deadline(timer) - std::chrono::steady_clock::now());
+            _timers.keeper.store(false);
+            if (notified && _timers.next.load() != UINT64_MAX) _idle.notify_one();
+            continue;
+        }
+        if (!_info.elastic) _idle.wait(key);
+        else if (!_idle.wait_for(key, _info.idleTimeout)) {
+            // Elastic pools retire workers above the minimum once idle for the timeout.
+            if (next_task(worker, callback)) return true;
+            if (retire(worker)) return false;
+        }
+    }
+}
+void __INTERNAL__Pool::execute_task(__INTERNAL__WorkerState& worker, Callback& callback_entry)
+{
+    const auto histogram    = worker.index * TASK_PRIORITY_MAX_ENUM + callback_entry.priority;
+    const auto started      = std::chrono::steady_clock::now();
+    auto& statistics        = *_statistics[worker.index];
+    _latency[histogram]->record(started - callback_entry.issued);
+    __INTERNAL__WorkerStatistics::add(statistics.tasks, 1);
+    // Skip withdrawn tasks without invoking them, otherwise invoke the
+    // callback method. Then release it's context (to free captured vars).
+    // A throwing task still completes: its fence is signalled and it is no
+    // longer pending (use submit to deliver the exception to the waiter).
+    auto& token = callback_entry.cancelOptional;
+    const bool cancelled = token && token->is_cancelled();
+    if (cancelled) _cancelled.fetch_add(1, std::memory_order_relaxed);
+    else if (callback_entry.callback) try {
+        callback_entry.callback();
+    } catch (std::exception& error) {
+        std::stringstream LOG;
+        LOG         << "[WARNING] Exception thrown on Iris Async callback thread: "
+                    << error.what() << "\n";
+        std::cerr   << LOG.str();
+    } catch (...) {
+        std::cerr   << "[WARNING] Unknown exception thrown on Iris Async callback thread\n";
+    }
+    callback_entry.callback         = nullptr;
+    callback_entry.cancelOptional   = nullptr;
+    if (_info.instrumentation) {
+        const auto runtime = std::chrono::duration_cast<std::chrono::nanoseconds>
+        (std::chrono::steady_clock::now() - started);
+        _runtime[histogram]->record(runtime);
+        __INTERNAL__WorkerStatistics::add(statistics.busy, runtime.count());
+    }
+    
+    // If there is a fence, trigger it to release any waiting threads.
+    auto fence = std::move(callback_entry.fenceOptional);
+    if (fence) {
+        if (cancelled) fence->cancelled = true;
+        fence->arrive();
+    }
+    auto pending = _pending.load();
+    while (!_pending.compare_exchange_weak(pending, pending?pending-1:0));
+    
+    // Draining workers parked on deferred tasks re-check whether any remain to wait upon.
+    if ((status & POOL_DRAINING) && _deferred.load()) _idle.notify_all();
+}
+bool __INTERNAL__Pool::awaiting_deferred() const
+{
+    // Deferred tasks are released by tasks still queued or running, or by other
+    // threads (which a draining pool does not wait upon). Loading the pending count
+    // first errs towards waiting; completing tasks notify the parked workers.
+    const size_t pending    = _pending.load();
+    const size_t deferred   = _deferred.load();
+    return deferred && pending > deferred;
+}
 
-                // Invoke the callback method and then release 
-                // it's context (to free captured vars).
-                callback_entry.callback();
-                callback_entry.callback = nullptr;
-                
-                // If there is a fence, trigger it to release any waiting threads.
-                auto fence = callback_entry.fenceOptional;
-                if (fence) {
-                    fence->complete = true;
-                    fence->complete.notify_all();
-                }
-                auto pending = _pending.load();
-                while (!_pending.compare_exchange_weak(pending, pending?pending-1:0));
+// MARK: - PARALLEL ALGORITHMS
+namespace {
+constexpr uint32_t PARALLEL_CLOSED = 1U << 31;
+struct __INTERNAL__ParallelRange {
+    std::atomic<TileIndex>      next;
+    const TileIndex             end;
+    const TileIndex             grain;
+    const uint32_t              participants;
+    const ChunkFunction&        function;
+    std::atomic<uint32_t>       users       = 0;    // Helpers inside the range (+ CLOSED bit)
+    std::atomic<uint32_t>       slots       = 0;    // Slots handed to helpers (caller is 0)
+    std::atomic_flag            failed;
+    std::exception_ptr          exception;
+    __INTERNAL__ParallelRange   (TileIndex begin, TileIndex end, TileIndex grain,
+                                 uint32_t participants, const ChunkFunction& function) :
+    next            (begin),
+    end             (end),
+    grain           (grain),
+    participants    (participants),
+    function        (function)
+    {
+    }
+    // Claim and run chunks until the range is consumed. Each claim takes an even
+    // share of the remainder so chunks shrink towards the grain near the end.
+    void run (uint32_t slot) {
+        try {
+            auto first = next.load(std::memory_order_relaxed);
+            while (first < end) {
+                TileIndex chunk = std::max<TileIndex>(grain, (end - first) / (2 * participants));
+                TileIndex last  = end - first > chunk ? first + chunk : end;
+                if (!next.compare_exchange_weak(first, last, std::memory_order_relaxed)) continue;
+                function(slot, first, last);
+                first = next.load(std::memory_order_relaxed);
             }
-        } catch (std::runtime_error& error) {
-            std::stringstream LOG;
-            LOG         << "[WARNING] Exception thrown on Iris Async callback thread: "
-                        << error.what() << "\n";
-            std::cerr   << LOG.str();
-            
-    
-            if (task_lock.owns_lock())
-                task_lock.unlock();
-            task_lock = MutexLock(_task_added_mtx, std::defer_lock);
+        } catch (...) {
+            // Keep the first exception and abandon the unclaimed remainder.
+            if (!failed.test_and_set()) exception = std::current_exception();
+            next.store(end, std::memory_order_relaxed);
         }
     }
+    // Helpers may start after the caller has returned; register before touching
+    // the function and back out once the range has been closed by the caller.
+    void help () {
+        auto current = users.load();
+        do if (current & PARALLEL_CLOSED) return;
+        while (!users.compare_exchange_weak(current, current + 1));
+        run(slots.fetch_add(1, std::memory_order_relaxed) + 1);
+        if (users.fetch_sub(1) == (PARALLEL_CLOSED | 1))
+            users.notify_all();
+    }
+    void close_and_wait () {
+        auto current = users.fetch_or(PARALLEL_CLOSED) | PARALLEL_CLOSED;
+        while (current != PARALLEL_CLOSED) {
+            users.wait(current);
+            current = users.load();
+        }
+    }
+};
+} // END ANONYMOUS NAMESPACE
+void __INTERNAL__parallel_chunks (const ThreadPool& pool, TileIndex begin, TileIndex end,
+                                  TileIndex grain, const ChunkFunction& function, TaskPriority priority)
+{
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+    
+    // Small ranges and missing pools are run inline without any pool traffic.
+    const TileIndex chunks  = (end - begin - 1) / grain + 1;
+    const uint32_t  helpers = pool ? std::min<uint32_t>(pool->thread_count(), chunks - 1) : 0;
+    if (helpers == 0) return function(0, begin, end);
+    
+    auto range = std::make_shared<__INTERNAL__ParallelRange>(begin, end, grain, helpers + 1, function);
+    LambdaPtrs tasks (helpers, [range](){ range->help(); });
+    pool->issue_tasks(tasks, priority);
+    
+    // The calling thread participates rather than blocking and then only waits
+    // for the chunks that helpers have already claimed.
+    range->run(0);
+    range->close_and_wait();
+    if (range->exception)
+        std::rethrow_exception(range->exception);
+}
+void parallel_for (const ThreadPool& pool, TileIndex begin, TileIndex end,
+                   TileIndex grain, const TileFunction& function, TaskPriority priority)
+{
+    __INTERNAL__parallel_chunks(pool, begin, end, grain,
+    [&function](uint32_t, TileIndex first, TileIndex last) {
+        for (TileIndex tile = first; tile < last; ++tile)
+            function(tile);
+    }, priority);
+}
+void parallel_for_2d (const ThreadPool& pool, const LayerExtent& extent,
+                      TileIndex grain, const TileFunction2D& function, TaskPriority priority)
+{
+    const uint32_t x_tiles = extent.xTiles;
+    if (x_tiles == 0 || extent.yTiles == 0) return;
+    __INTERNAL__parallel_chunks(pool, 0, x_tiles * extent.yTiles, grain,
+    [&function, x_tiles](uint32_t, TileIndex first, TileIndex last) {
+        uint32_t x = first % x_tiles, y = first / x_tiles;
+        for (TileIndex tile = first; tile < last; ++tile) {
+            function(x, y);
+            if (++x == x_tiles) { x = 0; ++y; }
+        }
+    }, priority);
 }
 } // END ASYNC NAMESPACE
 } // END IRIS NAMESAPCE
@@ -13,6 +13,21 @@
     #include <assert.h>
     #endif
 #endif
+#if defined _WIN32
+#include <malloc.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#if defined __linux__
+#include <stdio.h>
+#include <sys/syscall.h>
+#endif
 namespace Iris {
 // MARK: - IRIS EXPOSED API
 //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
@@ -26,6 +41,19 @@ Buffer Create_strong_buffer (size_t bytes)
 {
     return std::make_shared<__INTERNAL__Buffer>(REFERENCE_STRONG, bytes);
 }
+Buffer Create_strong_buffer (size_t bytes, BufferCreateFlags flags)
+{
+    // NUMA local blocks without an explicit node follow the calling thread.
+    const uint16_t node = flags & BUFFER_CREATE_NUMA_LOCAL ?
+    Get_thread_numa_node() : IRIS_NUMA_NODE_ANY;
+    return std::make_shared<__INTERNAL__Buffer>(REFERENCE_STRONG, bytes, flags, node);
+}
+Buffer Create_strong_buffer (size_t bytes, BufferCreateFlags flags, uint16_t numa_node)
+{
+    if (numa_node == IRIS_NUMA_NODE_ANY) numa_node = Get_thread_numa_node();
+    return std::make_shared<__INTERNAL__Buffer>
+    (REFERENCE_STRONG, bytes, (BufferCreateFlags)(flags|BUFFER_CREATE_NUMA_LOCAL), numa_node);
+}
 Buffer Copy_strong_buffer_from_data (const void* const data_ptr, size_t bytes)
 {
     return std::make_shared<__INTERNAL__Buffer>(REFERENCE_STRONG, data_ptr, bytes);
@@ -34,6 +62,49 @@ Buffer  Wrap_weak_buffer_fom_data   (const void* const data_ref, size_t bytes)
 {
     return std::make_shared<__INTERNAL__Buffer>(REFERENCE_WEAK, data_ref, bytes);
 }
+Buffer Map_buffer_from_file (const char* file_path, size_t offset, size_t bytes)
+{
+    if (file_path == nullptr) return nullptr;
+    
+    #if defined _WIN32
+    HANDLE file = CreateFileA(file_path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    Buffer buffer = nullptr;
+    try { buffer = Map_buffer_from_file_handle(file, offset, bytes); }
+    catch (...) { CloseHandle(file); throw; }
+    CloseHandle(file);
+    #else
+    int file = open(file_path, O_RDONLY);
+    if (file < 0) return nullptr;
+    Buffer buffer = nullptr;
+    try { buffer = Map_buffer_from_file_handle(file, offset, bytes); }
+    catch (...) { close(file); throw; }
+    close(file);
+    #endif
+    
+    return buffer;
+}
+Buffer Map_buffer_from_file_handle (NativeFileHandle file, size_t offset, size_t bytes)
+{
+    // Pages mapped beyond the end of the file raise SIGBUS when read,
+    // so the region must lie within the file.
+    #if defined _WIN32
+    LARGE_INTEGER __FILE_SIZE;
+    if (!GetFileSizeEx(file, &__FILE_SIZE)) return nullptr;
+    const size_t __END = static_cast<size_t>(__FILE_SIZE.QuadPart);
+    #else
+    struct stat __STAT;
+    if (fstat(file, &__STAT) != 0) return nullptr;
+    const size_t __END = static_cast<size_t>(__STAT.st_size);
+    #endif
+    if (offset > __END || bytes > __END - offset) throw std::runtime_error
+        ("Cannot map " + std::to_string(bytes) + " bytes at offset " + std::to_string(offset) +
+         " of a file of " + std::to_string(__END) + " bytes; the region extends beyond the end of the file.");
+    
+    auto buffer = std::make_shared<__INTERNAL__Buffer>(REFERENCE_MAPPED, file, offset, bytes);
+    return *buffer ? buffer : nullptr;
+}
 void*  Buffer_write_into_buffer (Buffer &__BUF, size_t& bytes)
 {
     switch (__BUF->get_strength()) {
@@ -50,8 +121,16 @@ void*  Buffer_write_into_buffer (Buffer &__BUF, size_t& bytes)
             return __BUF->data();
         case REFERENCE_STRONG:
             return __BUF->append(bytes);
+        case REFERENCE_MAPPED:
+            throw std::runtime_error
+            ("Attempting to write into a MAPPED IrisCodec buffer. Mapped buffers are read-only.");
     } return nullptr;
 }
+Result Buffer_set_tag (const Buffer &__BUF, BufferTag tag)
+{
+    if (!__BUF) return IRIS_FAILURE;
+    return __BUF->set_tag(tag);
+}
 Result Buffer_get_data (const Buffer &__BUF, void*& data, size_t& bytes)
 {
     data    = __BUF->data();
@@ -59,6 +138,205 @@ Result Buffer_get_data (const Buffer &__BUF, void*& data, size_t& bytes)
     
     return IRIS_SUCCESS;
 }
+// MARK: - ALLOCATION ACCOUNTING
+namespace {
+struct __ALLOCATION_COUNTERS {
+    atomic_size         live            = 0;
+    atomic_size         peak            = 0;
+    atomic_uint64       allocations     = 0;
+    atomic_uint64       releases        = 0;
+    atomic_uint64       reallocations   = 0;
+    void RAISE (size_t bytes)
+    {
+        size_t __P = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t __C = peak.load(std::memory_order_relaxed);
+        while (__P > __C && !peak.compare_exchange_weak(__C, __P, std::memory_order_relaxed));
+    }
+    void LOWER (size_t bytes)
+    {
+        live.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+    BufferAllocationStats SNAPSHOT () const
+    {
+        return BufferAllocationStats {
+            .liveBytes      = live.load(),
+            .peakBytes      = peak.load(),
+            .allocations    = allocations.load(),
+            .releases       = releases.load(),
+            .reallocations  = reallocations.load(),
+        };
+    }
+};
+__ALLOCATION_COUNTERS ALLOCATION_TOTAL;
+__ALLOCATION_COUNTERS ALLOCATION_TAGS [BUFFER_TAG_MAX_ENUM];
+inline __ALLOCATION_COUNTERS& TAG_COUNTERS (BufferTag tag)
+{
+    return ALLOCATION_TAGS[tag < BUFFER_TAG_MAX_ENUM ? tag : BUFFER_TAG_UNTAGGED];
+}
+inline void ACCOUNT_ALLOCATE (BufferTag tag, size_t bytes)
+{
+    for (auto counters : {&ALLOCATION_TOTAL, &TAG_COUNTERS(tag)}) {
+        counters->allocations.fetch_add(1, std::memory_order_relaxed);
+        counters->RAISE(bytes);
+    }
+}
+inline void ACCOUNT_RELEASE (BufferTag tag, size_t bytes)
+{
+    for (auto counters : {&ALLOCATION_TOTAL, &TAG_COUNTERS(tag)}) {
+        counters->releases.fetch_add(1, std::memory_order_relaxed);
+        counters->LOWER(bytes);
+    }
+}
+inline void ACCOUNT_REALLOCATE (BufferTag tag, size_t old_bytes, size_t new_bytes)
+{
+    for (auto counters : {&ALLOCATION_TOTAL, &TAG_COUNTERS(tag)}) {
+        counters->reallocations.fetch_add(1, std::memory_order_relaxed);
+        if (new_bytes > old_bytes)  counters->RAISE(new_bytes - old_bytes);
+        else                        counters->LOWER(old_bytes - new_bytes);
+    }
+}
+} // END ANONYMOUS NAMESPACE
+BufferAllocationStats Get_buffer_allocation_stats (BufferTag tag)
+{
+    return TAG_COUNTERS(tag).SNAPSHOT();
+}
+BufferAllocationStats Get_buffer_allocation_stats ()
+{
+    return ALLOCATION_TOTAL.SNAPSHOT();
+}
+// MARK: - NUMA PLACEMENT
+namespace {
+thread_local uint16_t THREAD_NUMA_NODE = IRIS_NUMA_NODE_ANY;
+uint16_t READ_NUMA_NODE_COUNT ()
+{
+    #if defined __linux__
+    // The online node list is a range list such as "0" or "0-1" (or "0,2-3")
+    FILE* list = fopen("/sys/devices/system/node/online", "r");
+    if (list == nullptr) return 1;
+    unsigned first = 0, last = 0, count = 1;
+    for (int read; (read = fscanf(list, "%u-%u", &first, &last)) > 0;) {
+        if (read == 1) last = first;
+        if (last + 1 > count) count = last + 1;
+        if (fgetc(list) != ',') break;
+    } fclose(list);
+    return static_cast<uint16_t>(count < IRIS_BUFFER_NUMA_MAX_NODES ? count : IRIS_BUFFER_NUMA_MAX_NODES);
+    #else
+    return 1;
+    #endif
+}
+// Set the memory policy of a block mapped for it (see ALLOCATE_BLOCK) to
+// prefer the given node. The pages are placed on the node when first touched.
+void BIND_BLOCK (void* block, size_t capacity, uint16_t node)
+{
+    #if defined __linux__ && defined SYS_mbind
+    if (block == nullptr || Get_numa_node_count() < 2 || node >= Get_numa_node_count()) return;
+    constexpr int       __MPOL_PREFERRED    = 1;
+    constexpr unsigned  __MPOL_MF_MOVE      = 1U << 1;
+    constexpr size_t    __BITS              = sizeof(unsigned long) * 8;
+    unsigned long mask [IRIS_BUFFER_NUMA_MAX_NODES / __BITS] = {};
+    mask[node / __BITS] = 1UL << (node % __BITS);
+    
+    // Placement is a hint; on failure the block remains usable under the default policy.
+    syscall(SYS_mbind, block, capacity, __MPOL_PREFERRED, mask,
+            IRIS_BUFFER_NUMA_MAX_NODES, __MPOL_MF_MOVE);
+    #endif
+}
+} // END ANONYMOUS NAMESPACE
+uint16_t Get_numa_node_count ()
+{
+    static const uint16_t NUMA_NODE_COUNT = READ_NUMA_NODE_COUNT();
+    return NUMA_NODE_COUNT;
+}
+void Set_thread_numa_node (uint16_t numa_node)
+{
+    THREAD_NUMA_NODE = numa_node;
+}
+uint16_t Get_thread_numa_node ()
+{
+    return THREAD_NUMA_NODE;
+}
+// MARK: - BLOCK ALLOCATION
+namespace {
+inline size_t BLOCK_ALIGNMENT (BufferCreateFlags flags)
+{
+    if (flags & BUFFER_CREATE_HUGE_PAGES)   return IRIS_BUFFER_HUGE_PAGE_SIZE;
+    if (flags & BUFFER_CREATE_NUMA_LOCAL)   return IRIS_BUFFER_NUMA_PAGE_SIZE;
+    if (flags & BUFFER_CREATE_ALIGNED)      return IRIS_BUFFER_ALIGNMENT;
+    return 0;
+}
+// Allocate a data block. Huge page and NUMA local blocks round the capacity
+// up to a whole number of pages (capacity is updated). NUMA local blocks
+// without a node are placed by the first touch of the calling thread.
+void* ALLOCATE_BLOCK (size_t& capacity, BufferCreateFlags flags, uint16_t node = IRIS_NUMA_NODE_ANY)
+{
+    const size_t alignment = BLOCK_ALIGNMENT(flags);
+    if (alignment == 0)
+        return std::malloc(capacity);
+    
+    if (flags & (BUFFER_CREATE_HUGE_PAGES|BUFFER_CREATE_NUMA_LOCAL))
+        capacity = (capacity + alignment - 1) & ~(alignment - 1);
+    
+    void* block = nullptr;
+    #if defined _WIN32
+    block = _aligned_malloc(capacity, alignment);
+    #else
+    // NUMA local blocks are given a private mapping rather than heap memory.
+    // A node policy applies to whole mappings: set on heap memory, it would
+    // split the heap's mapping and outlive the block, steering unrelated
+    // later allocations onto the node. Huge page blocks over-map and trim
+    // the mapping to keep their alignment.
+    if (flags & BUFFER_CREATE_NUMA_LOCAL) {
+        const size_t __EXTRA = flags & BUFFER_CREATE_HUGE_PAGES ? alignment : 0;
+        void* __map = mmap(nullptr, capacity + __EXTRA, PROT_READ|PROT_WRITE,
+                           MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+        if (__map == MAP_FAILED) return nullptr;
+        const uintptr_t __BASE  = reinterpret_cast<uintptr_t>(__map);
+        const uintptr_t __START = (__BASE + alignment - 1) & ~(alignment - 1);
+        if (__EXTRA) {
+            if (__START > __BASE) munmap(__map, __START - __BASE);
+            if (__BASE + __EXTRA > __START)
+                munmap(reinterpret_cast<void*>(__START + capacity), __BASE + __EXTRA - __START);
+        }
+        block = reinterpret_cast<void*>(__START);
+    } else if (posix_memalign(&block, alignment, capacity))
+        return nullptr;
+    #endif
+    
+    #if defined MADV_HUGEPAGE
+    if (block && (flags & BUFFER_CREATE_HUGE_PAGES))
+        madvise(block, capacity, MADV_HUGEPAGE);
+    #endif
+    
+    if (block && (flags & BUFFER_CREATE_NUMA_LOCAL) && node != IRIS_NUMA_NODE_ANY)
+        BIND_BLOCK(block, capacity, node);
+    return block;
+}
+void FREE_BLOCK (void* block, [[maybe_unused]] size_t capacity, BufferCreateFlags flags)
+{
+    #if defined _WIN32
+    if (BLOCK_ALIGNMENT(flags)) return _aligned_free(block);
+    #else
+    if (flags & BUFFER_CREATE_NUMA_LOCAL) { munmap(block, capacity); return; }
+    #endif
+    std::free(block);
+}
+// Resize a data block, preserving its contents up to the smaller of the
+// two capacities. Aligned blocks cannot use realloc (it does not preserve
+// alignment) and are moved into a fresh aligned allocation.
+void* REALLOCATE_BLOCK (void* block, size_t old_capacity, size_t& capacity, BufferCreateFlags flags,
+                        uint16_t node = IRIS_NUMA_NODE_ANY)
+{
+    if (BLOCK_ALIGNMENT(flags) == 0)
+        return std::realloc(block, capacity);
+    
+    void* __ptr = ALLOCATE_BLOCK(capacity, flags, node);
+    if (__ptr == nullptr) return nullptr;
+    if (block) {
+        std::memcpy(__ptr, block, old_capacity < capacity ? old_capacity : capacity);
+        FREE_BLOCK(block, old_capacity, flags);
+    } return __ptr;
+}
+} // END ANONYMOUS NAMESPACE
 // MARK: - IRIS INTERNALS
 //  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
 //  IRIS CODEC EXPOSED API                                  //
@@ -80,6 +358,25 @@ _data       (malloc(__C))
     #if IRIS_DEBUG
     assert  (_ref == REFERENCE_STRONG);
     #endif
+    
+    if (_data) ACCOUNT_ALLOCATE(_tag, __C);
+    else _capacity = 0;
+}
+__INTERNAL__Buffer::__INTERNAL__Buffer (BufferReferenceStrength _ref, size_t __C, BufferCreateFlags __F, uint16_t __N) noexcept :
+_strength   (_ref),
+_flags      (__F),
+_node       (__N),
+_capacity   (__C),
+_data       (ALLOCATE_BLOCK(__C, __F, __N))
+{
+    // Only create a buffer with strong reference
+    #if IRIS_DEBUG
+    assert  (_ref == REFERENCE_STRONG);
+    #endif
+    
+    // Huge page and NUMA local blocks may have been rounded up
+    _capacity = _data ? __C : 0;
+    if (_data) ACCOUNT_ALLOCATE(_tag, __C);
 }
 __INTERNAL__Buffer::__INTERNAL__Buffer (BufferReferenceStrength _ref, const void* const __D, size_t __S) noexcept :
 _strength   (_ref),
@@ -96,23 +393,88 @@ _data       (nullptr)
     switch (_strength) {
         case REFERENCE_STRONG:
             const_cast<void*&>(_data) = std::malloc(__S);
+            if (_data == nullptr) {
+                _capacity   = 0;
+                _size       = 0;
+                break;
+            }
             std::memcpy(_data, __D, _size);
+            ACCOUNT_ALLOCATE(_tag, __S);
             break;
         case REFERENCE_WEAK:
             const_cast<void*&>(_data) = const_cast<void*&>(__D);
             break;
+        case REFERENCE_MAPPED:
+            // Mapped buffers must be created from a file handle
+            _capacity   = 0;
+            _size       = 0;
+            break;
     }
 }
+__INTERNAL__Buffer::__INTERNAL__Buffer (BufferReferenceStrength _ref, NativeFileHandle __F, size_t __O, size_t __S) noexcept :
+_strength   (_ref),
+_capacity   (0),
+_size       (0),
+_data       (nullptr)
+{
+    // Only create a mapped buffer from a file handle
+    #if IRIS_DEBUG
+    assert  (_ref == REFERENCE_MAPPED);
+    #endif
+    if (_ref != REFERENCE_MAPPED || __S == 0) return;
+    
+    // Mappings must begin on an allocation granularity boundary.
+    // Map from the preceding boundary and offset the data pointer.
+    #if defined _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t __ALIGNED  = __O - __O % info.dwAllocationGranularity;
+    const size_t __LENGTH   = __S + (__O - __ALIGNED);
+    HANDLE mapping = CreateFileMappingA(__F, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) return;
+    _map_base = MapViewOfFile(mapping, FILE_MAP_READ,
+                              static_cast<DWORD>(static_cast<uint64_t>(__ALIGNED) >> 32),
+                              static_cast<DWORD>(__ALIGNED & 0xFFFFFFFF),
+                              __LENGTH);
+    CloseHandle(mapping); // The view keeps the mapping alive
+    if (_map_base == NULL) return;
+    #else
+    const size_t __PAGE     = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t __ALIGNED  = __O - __O % __PAGE;
+    const size_t __LENGTH   = __S + (__O - __ALIGNED);
+    void* __ptr = mmap(nullptr, __LENGTH, PROT_READ, MAP_SHARED, __F, static_cast<off_t>(__ALIGNED));
+    if (__ptr == MAP_FAILED) return;
+    _map_base = __ptr;
+    #endif
+    
+    _map_length = __LENGTH;
+    _capacity   = __S;
+    _size       = __S;
+    const_cast<void*&>(_data) = static_cast<uint8_t*>(_map_base) + (__O - __ALIGNED);
+}
 __INTERNAL__Buffer::~__INTERNAL__Buffer()
 {
-    _capacity   = 0;
+    // Release the view held on the parent's block.
+    // The parent reference itself is released after this.
+    if (_parent) _parent->_views.fetch_sub(1, std::memory_order_acq_rel);
+    
+    size_t __CAPACITY = _capacity.exchange(0);
     _size       = 0;
     switch (_strength) {
         case REFERENCE_STRONG:
-            if (_data) free(_data);
-            return;
+            if (_data) {
+                FREE_BLOCK          (_data, __CAPACITY, _flags);
+                ACCOUNT_RELEASE     (_tag, __CAPACITY);
+            } return;
         case REFERENCE_WEAK:
             return;
+        case REFERENCE_MAPPED:
+            #if defined _WIN32
+            if (_map_base) UnmapViewOfFile(_map_base);
+            #else
+            if (_map_base) munmap(_map_base, _map_length);
+            #endif
+            return;
     }
 }
 __INTERNAL__Buffer::operator void *const() const
@@ -129,9 +491,77 @@ BufferReferenceStrength __INTERNAL__Buffer::get_strength() const
 }
 Result __INTERNAL__Buffer::change_strength(BufferReferenceStrength _assign)
 {
+    // A mapping can only be released by munmap; it cannot be
+    // adopted as (or created from) a heap allocation.
+    if (_strength == REFERENCE_MAPPED || _assign == REFERENCE_MAPPED)
+        return IRIS_FAILURE;
+    // A slice points into the middle of its parent's block.
+    if (_parent) return IRIS_FAILURE;
+    
+    // Adopting or relinquishing the block moves it in or out of the accounts.
+    if (_data && _strength != _assign) {
+        if (_assign == REFERENCE_STRONG)    ACCOUNT_ALLOCATE(_tag, _capacity);
+        else                                ACCOUNT_RELEASE (_tag, _capacity);
+    }
     _strength = _assign;
     return IRIS_SUCCESS;
 }
+BufferCreateFlags __INTERNAL__Buffer::get_flags() const
+{
+    return _flags;
+}
+uint16_t __INTERNAL__Buffer::get_numa_node() const
+{
+    return _node;
+}
+Result __INTERNAL__Buffer::set_growth_policy(BufferGrowthPolicy policy, float factor)
+{
+    _growth = policy;
+    _factor = factor < 1.125f ? 1.125f : factor;
+    return IRIS_SUCCESS;
+}
+BufferGrowthPolicy __INTERNAL__Buffer::get_growth_policy() const
+{
+    return _growth;
+}
+Result __INTERNAL__Buffer::set_tag(BufferTag tag)
+{
+    if (tag >= BUFFER_TAG_MAX_ENUM)
+        return IRIS_FAILURE;
+    
+    // Move the owned block (its bytes and its allocation) between the
+    // tag accounts without counting it as a release and allocation, so
+    // each tag's allocations less releases remains its live block count.
+    ExclusiveLock retag_lock (_resize);
+    if (_strength == REFERENCE_STRONG && _data) {
+        auto& from  = TAG_COUNTERS(_tag);
+        auto& to    = TAG_COUNTERS(tag);
+        from.allocations.fetch_sub(1, std::memory_order_relaxed);
+        from.LOWER(_capacity);
+        to.allocations.fetch_add(1, std::memory_order_relaxed);
+        to.RAISE(_capacity);
+    }
+    _tag = tag;
+    return IRIS_SUCCESS;
+}
+BufferTag __INTERNAL__Buffer::get_tag() const
+{
+    return _tag;
+}
+void __INTERNAL__Buffer::set_format(Format format)
+{
+    _format = format;
+}
+Format __INTERNAL__Buffer::get_format() const
+{
+    return _format;
+}
+Result __INTERNAL__Buffer::reserve_hint(size_t bytes)
+{
+    if (_capacity >= bytes)
+        return IRIS_SUCCESS;
+    return change_capacity(bytes);
+}
 void* __INTERNAL__Buffer::data() const
 {
     return _data;
@@ -151,19 +581,20 @@ void* __INTERNAL__Buffer::append(size_t __S)
 {
     // COPY the old size of the image as we will change
     // the underlying data structure and need to check it.
-    auto __OLD_SIZE = _size;
+    size_t __OLD_SIZE = _size;
     
     // If there are insufficient bytes, expand the buffer
+    // according to the buffer's growth policy.
     if (available_bytes() < __S) {
         // A resize failure returns a null pointer
-        if (change_capacity(_capacity + __S - available_bytes()) == IRIS_FAILURE)
+        if (change_capacity(NEXT_CAPACITY(__OLD_SIZE + __S)) == IRIS_FAILURE)
             return NULL;
         // Ensure we didn't make the buffer smaller.
         // resize can do that and that would be awkward...
         #if IRIS_DEBUG
-        assert  (_capacity >= __OLD_SIZE && "Attempted to expand a buffer but actally reduced the size...");
+        assert  (_capacity >= __OLD_SIZE + __S && "Attempted to expand a buffer but actally reduced the size...");
         #endif
-        if      (_capacity <  __OLD_SIZE)
+        if      (_capacity <  __OLD_SIZE + __S)
             return NULL;
     }
     // Update the size. We can assume that any new
@@ -174,19 +605,20 @@ void* __INTERNAL__Buffer::append(size_t __S)
 Result __INTERNAL__Buffer::append(void *__D, size_t __S)
 {
     
-    auto __OLD_SIZE = _size;
+    size_t __OLD_SIZE = _size;
     
     // If there are insufficient bytes, expand the buffer
+    // according to the buffer's growth policy.
     if (available_bytes() < __S) {
         // A resize failure returns a null pointer
-        if (change_capacity(available_bytes() + __S) == IRIS_FAILURE)
+        if (change_capacity(NEXT_CAPACITY(__OLD_SIZE + __S)) == IRIS_FAILURE)
             return IRIS_FAILURE;
         // Ensure we didn't make the buffer smaller.
         // resize can do that and that would be awkward...
         #if IRIS_DEBUG
-        assert  (_size <= __OLD_SIZE);
+        assert  (_capacity >= __OLD_SIZE + __S);
         #endif
-        if      (_size <= __OLD_SIZE)
+        if      (_capacity <  __OLD_SIZE + __S)
             return IRIS_FAILURE;
     }
     
@@ -223,24 +655,489 @@ Result __INTERNAL__Buffer::change_capacity(size_t capacity)
     #if IRIS_DEBUG
     assert(_strength == REFERENCE_STRONG);
     #endif
-    if (_strength == REFERENCE_WEAK)
+    if (_strength != REFERENCE_STRONG)
         return IRIS_FAILURE;
     
     // IF this is unnessary, return true
     if (capacity == _capacity)
         return IRIS_SUCCESS;
     
-    // Else reallocate the pointer, invalidating the old one
-    if (auto __ptr = std::realloc(_data, capacity)) {
-        _size = (_size < capacity) ? _size : capacity;
-        const_cast<size_t&> (_capacity) = capacity;
+    // Wait for any concurrent readers / writers to release the block
+    ExclusiveLock relocate_lock (_resize);
+    return RESIZE_INTERNAL(capacity);
+}
+Result __INTERNAL__Buffer::shrink_to_fit()
+{
+    return change_capacity(_size);
+}
+Result __INTERNAL__Buffer::reserve_concurrent(size_t __S, size_t& offset)
+{
+    if (_strength != REFERENCE_STRONG)
+        return IRIS_FAILURE;
+    
+    // Claim the region. This is the only point of contention between
+    // writers: a compare-exchange that never claims beyond the capacity,
+    // so a reservation that cannot be grown into leaves nothing behind.
+    offset = _size.load(std::memory_order_acquire);
+    for (;;) {
+        const size_t __REQUIRED = offset + __S;
+        if (__REQUIRED <= _capacity.load(std::memory_order_acquire)) {
+            if (_size.compare_exchange_weak(offset, __REQUIRED, std::memory_order_acq_rel))
+                return IRIS_SUCCESS;
+            continue;
+        }
+        
+        // The reservation overflows the block. Take the exclusive lock
+        // (waiting for in-flight copies into the old block) and grow
+        // geometrically so that a burst of writers only relocates once.
+        // Exact growth is never used here as contending writers would
+        // each relocate the block in turn.
+        {   ExclusiveLock relocate_lock (_resize);
+            const size_t __CAPACITY = _capacity.load(std::memory_order_relaxed);
+            if (__REQUIRED > __CAPACITY &&
+                RESIZE_INTERNAL(std::max(NEXT_CAPACITY(__REQUIRED), __CAPACITY * 2)) == IRIS_FAILURE)
+                return IRIS_FAILURE;
+        }   offset = _size.load(std::memory_order_acquire);
+    }
+}
+Result __INTERNAL__Buffer::write_concurrent(size_t offset, const void *__D, size_t __S)
+{
+    // Hold off relocation of the block while copying.
+    SharedLock write_lock (_resize);
+    if (offset + __S > _capacity.load(std::memory_order_acquire))
+        return IRIS_FAILURE;
+    std::memcpy(static_cast<uint8_t*>(_data) + offset, __D, __S);
+    return IRIS_SUCCESS;
+}
+Result __INTERNAL__Buffer::append_concurrent(const void *__D, size_t __S)
+{
+    size_t offset = 0;
+    if (reserve_concurrent(__S, offset) == IRIS_FAILURE)
+        return IRIS_FAILURE;
+    return write_concurrent(offset, __D, __S);
+}
+Result __INTERNAL__Buffer::advise(BufferAdvice advice) const
+{
+    if (_strength != REFERENCE_MAPPED || _map_base == nullptr)
+        return IRIS_FAILURE;
+    
+    #if defined _WIN32
+    return IRIS_SUCCESS;
+    #else
+    int __ADVICE = MADV_NORMAL;
+    switch (advice) {
+        case BUFFER_ADVICE_NORMAL:      __ADVICE = MADV_NORMAL;     break;
+        case BUFFER_ADVICE_WILLNEED:    __ADVICE = MADV_WILLNEED;   break;
+        case BUFFER_ADVICE_SEQUENTIAL:  __ADVICE = MADV_SEQUENTIAL; break;
+        case BUFFER_ADVICE_DONTNEED:    __ADVICE = MADV_DONTNEED;   break;
+    }
+    return madvise(_map_base, _map_length, __ADVICE) == 0 ?
+    IRIS_SUCCESS : IRIS_FAILURE;
+    #endif
+}
+Buffer __INTERNAL__Buffer::slice(size_t offset, size_t bytes)
+{
+    Buffer parent = weak_from_this().lock();
+    if (!parent) return nullptr;
+    
+    // Hold off relocation while the view is established.
+    // Once _views is raised, the block is pinned.
+    SharedLock slice_lock (_resize);
+    if (_data == nullptr || offset > _size || bytes > _size - offset)
+        return nullptr;
+    
+    auto child = std::make_shared<__INTERNAL__Buffer>
+    (REFERENCE_WEAK, static_cast<uint8_t*>(_data) + offset, bytes);
+    _views.fetch_add(1, std::memory_order_acq_rel);
+    child->_parent = std::move(parent);
+    return child;
+}
+ReadLock __INTERNAL__Buffer::lock_for_reading() const
+{
+    return ReadLock (_resize);
+}
+size_t __INTERNAL__Buffer::NEXT_CAPACITY(size_t __R) const
+{
+    switch (_growth) {
+        case BUFFER_GROWTH_EXACT:
+            return __R;
+        case BUFFER_GROWTH_GEOMETRIC: {
+            const size_t __G = static_cast<size_t>(_capacity * static_cast<double>(_factor));
+            return __G > __R ? __G : __R;
+        }
+        case BUFFER_GROWTH_PAGE: {
+            #if defined _WIN32
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            const size_t __PAGE = info.dwPageSize;
+            #else
+            static const size_t __PAGE = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            #endif
+            return (__R + __PAGE - 1) / __PAGE * __PAGE;
+        }
+    } return __R;
+}
+Result __INTERNAL__Buffer::RESIZE_INTERNAL(size_t capacity)
+{
+    // Slices point into this block; it must not move.
+    if (_views.load(std::memory_order_acquire))
+        return IRIS_FAILURE;
+    
+    // Reallocate the pointer, invalidating the old one.
+    // The calling method must hold the exclusive relocation lock.
+    const size_t __OLD_CAPACITY = _capacity.load(std::memory_order_relaxed);
+    if (auto __ptr = REALLOCATE_BLOCK(_data, __OLD_CAPACITY, capacity, _flags, _node)) {
+        if (_data)  ACCOUNT_REALLOCATE  (_tag, __OLD_CAPACITY, capacity);
+        else        ACCOUNT_ALLOCATE    (_tag, capacity);
+        // Clamp the size when shrinking; growth leaves it to concurrent reservations.
+        size_t __SIZE = _size.load(std::memory_order_relaxed);
+        while (__SIZE > capacity && !_size.compare_exchange_weak(__SIZE, capacity, std::memory_order_relaxed));
+        _capacity.store (capacity, std::memory_order_release);
         const_cast<void*&>  (_data)     = __ptr;
         return IRIS_SUCCESS;
     }
     return IRIS_FAILURE;
 }
-Result __INTERNAL__Buffer::shrink_to_fit()
+// MARK: - BUFFER CHAIN
+//  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
+//  BUFFER CHAIN                                            //
+//  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
+namespace {
+#if defined IOV_MAX && IOV_MAX < 1024
+constexpr int CHAIN_IOV_BATCH = IOV_MAX;
+#else
+constexpr int CHAIN_IOV_BATCH = 1024;
+#endif
+// Issue vectored writes until every segment is written, resuming
+// within a segment after a partial write. __WRITE is called with a batch of
+// at most CHAIN_IOV_BATCH entries and the number of bytes already written
+// and returns the number of bytes written by the call (or -1 and errno).
+template <class __WRITE>
+Result WRITE_VECTORED (const std::vector<iovec>& segments, __WRITE write_call)
 {
-    return change_capacity(_size);
+    iovec       batch[CHAIN_IOV_BATCH];
+    size_t      index   = 0;    // First incompletely written segment
+    size_t      skip    = 0;    // Bytes of that segment already written
+    size_t      written = 0;
+    while (index < segments.size()) {
+        int count = 0;
+        for (; count < CHAIN_IOV_BATCH && index + count < segments.size(); ++count)
+            batch[count] = segments[index + count];
+        batch[0].iov_base = static_cast<uint8_t*>(batch[0].iov_base) + skip;
+        batch[0].iov_len -= skip;
+        
+        int64_t result = write_call(batch, count, written);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) return Result
+            (IRIS_FAILURE, std::string("Buffer chain vectored write failed after ") +
+             std::to_string(written) + " bytes: " + std::strerror(result ? errno : EIO));
+        
+        // Advance past every completely written segment.
+        written        += static_cast<size_t>(result);
+        size_t advance  = static_cast<size_t>(result) + skip;
+        while (index < segments.size() && advance >= segments[index].iov_len)
+            advance    -= segments[index++].iov_len;
+        skip            = advance;
+    }
+    return IRIS_SUCCESS;
+}
+#if defined _WIN32
+// Windows has no gather write for buffered file handles.
+// Write the batch sequentially, stopping at a short write.
+int64_t WRITE_BATCH_WIN32 (HANDLE file, const iovec* batch, int count, const size_t* offset)
+{
+    int64_t total = 0;
+    for (int __I = 0; __I < count; ++__I) {
+        DWORD length    = static_cast<DWORD>(std::min<size_t>(batch[__I].iov_len, 1U << 30));
+        DWORD written   = 0;
+        OVERLAPPED position {};
+        if (offset) {
+            uint64_t __O        = *offset + total;
+            position.Offset     = static_cast<DWORD>(__O & 0xFFFFFFFF);
+            position.OffsetHigh = static_cast<DWORD>(__O >> 32);
+        }
+        if (!WriteFile(file, batch[__I].iov_base, length, &written, offset ? &position : NULL)) {
+            if (total) return total;
+            errno = EIO;
+            return -1;
+        }
+        total += written;
+        if (written < batch[__I].iov_len) break;
+    }
+    return total;
+}
+#endif
+} // END ANONYMOUS NAMESPACE
+Result BufferChain::append(const Buffer& buffer)
+{
+    if (!buffer) return IRIS_FAILURE;
+    return append(buffer, 0, buffer->size());
+}
+Result BufferChain::append(const Buffer& buffer, size_t offset, size_t bytes)
+{
+    if (!buffer || offset > buffer->size() || bytes > buffer->size() - offset)
+        return IRIS_FAILURE;
+    if (bytes == 0) return IRIS_SUCCESS;
+    
+    _buffers.push_back(buffer);
+    _iovecs.push_back(iovec {
+        .iov_base   = static_cast<uint8_t*>(buffer->data()) + offset,
+        .iov_len    = bytes,
+    });
+    _size += bytes;
+    return IRIS_SUCCESS;
+}
+size_t BufferChain::size() const
+{
+    return _size;
+}
+size_t BufferChain::segment_count() const
+{
+    return _iovecs.size();
+}
+const iovec* BufferChain::iovecs() const
+{
+    return _iovecs.data();
+}
+void BufferChain::clear()
+{
+    _buffers.clear();
+    _iovecs.clear();
+    _size = 0;
+}
+Buffer BufferChain::flatten() const
+{
+    auto buffer = Create_strong_buffer(_size);
+    if (!buffer || (_size && !buffer->data())) return nullptr;
+    for (auto& segment : _iovecs)
+        buffer->append(segment.iov_base, segment.iov_len);
+    return buffer;
+}
+Result BufferChain::write(NativeFileHandle file) const
+{
+    return WRITE_VECTORED(_iovecs, [file](const iovec* batch, int count, size_t) -> int64_t {
+        #if defined _WIN32
+        return WRITE_BATCH_WIN32(file, batch, count, nullptr);
+        #else
+        return writev(file, batch, count);
+        #endif
+    });
+}
+Result BufferChain::write_at(NativeFileHandle file, size_t offset) const
+{
+    return WRITE_VECTORED(_iovecs, [file, offset](const iovec* batch, int count, size_t written) -> int64_t {
+        #if defined _WIN32
+        const size_t position = offset + written;
+        return WRITE_BATCH_WIN32(file, batch, count, &position);
+        #else
+        return pwritev(file, batch, count, static_cast<off_t>(offset + written));
+        #endif
+    });
+}
+// MARK: - TILE BUFFER POOL
+//  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
+//  TILE BUFFER POOL                                        //
+//  ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ //
+namespace {
+constexpr size_t TILE_POOL_CLASSES[] = {
+    TILE_PIX_BYTES_RGB,
+    TILE_PIX_BYTES_RGBA,
+};
+constexpr size_t TILE_POOL_CLASS_COUNT = sizeof(TILE_POOL_CLASSES)/sizeof(size_t);
+inline int TILE_POOL_CLASS (size_t capacity)
+{
+    for (size_t __C = 0; __C < TILE_POOL_CLASS_COUNT; ++__C)
+        if (TILE_POOL_CLASSES[__C] == capacity) return static_cast<int>(__C);
+    return -1;
+}
+struct __TILE_POOL {
+    atomic_size         retained    = 0;
+    atomic_size         limit       = IRIS_TILE_POOL_LIMIT;
+    atomic_uint64       hits        = 0;
+    atomic_uint64       misses      = 0;
+    atomic_uint64       releases    = 0;
+    atomic_uint64       evictions   = 0;
+    Mutex               depotLock;
+    std::vector<void*>  depot       [TILE_POOL_CLASS_COUNT];    // Shared between threads
+    Mutex               registryLock;
+    std::vector<struct __TILE_POOL_CACHE*> caches;              // Every live thread list
+};
+// Never destroyed; blocks may be released during exit by threads that outlive it.
+__TILE_POOL& TILE_POOL = *new __TILE_POOL;
+constexpr size_t TILE_POOL_BATCH = IRIS_TILE_POOL_THREAD_BLOCKS / 2 ?
+IRIS_TILE_POOL_THREAD_BLOCKS / 2 : 1;
+// Per-thread free lists of up to IRIS_TILE_POOL_THREAD_BLOCKS blocks per class.
+// Blocks are returned to the list of the thread that destroys the last Buffer
+// reference; an over-full list spills into the shared depot, from which an
+// empty list refills, one depot lock per batch. The list lock is only
+// contended while the retained limit is lowered.
+struct __TILE_POOL_CACHE {
+    Mutex               lock;
+    std::vector<void*>  blocks      [TILE_POOL_CLASS_COUNT];
+    explicit __TILE_POOL_CACHE      ();
+   ~__TILE_POOL_CACHE               ();
+};
+// The cache lifetime is tracked in a trivially destructible thread_local
+// as buffers may be destroyed during thread exit after the cache itself.
+enum __TILE_POOL_CACHE_STATE : uint8_t {
+    CACHE_UNINITIALIZED,
+    CACHE_ALIVE,
+    CACHE_DESTROYED,
+};
+thread_local __TILE_POOL_CACHE_STATE TILE_POOL_CACHE_STATE = CACHE_UNINITIALIZED;
+thread_local __TILE_POOL_CACHE TILE_POOL_CACHE;
+// Free blocks from the back of a free list while the pool retains more than
+// the limit. Every block is counted as retained, so a limit of 0 frees them all.
+void TILE_POOL_FREE (std::vector<void*>& blocks, size_t __C, size_t limit)
+{
+    while (blocks.size() && TILE_POOL.retained.load() > limit) {
+        FREE_BLOCK(blocks.back(), TILE_POOL_CLASSES[__C], BUFFER_CREATE_ALIGNED);
+        blocks.pop_back();
+        TILE_POOL.retained.fetch_sub(TILE_POOL_CLASSES[__C]);
+    }
+}
+__TILE_POOL_CACHE::__TILE_POOL_CACHE ()
+{
+    MutexLock registry_lock (TILE_POOL.registryLock);
+    TILE_POOL.caches.push_back(this);
+    TILE_POOL_CACHE_STATE = CACHE_ALIVE;
+}
+__TILE_POOL_CACHE::~__TILE_POOL_CACHE ()
+{
+    {   MutexLock registry_lock (TILE_POOL.registryLock);
+        auto& caches = TILE_POOL.caches;
+        caches.erase(std::find(caches.begin(), caches.end(), this));
+    }
+    TILE_POOL_CACHE_STATE = CACHE_DESTROYED;
+    for (size_t __C = 0; __C < TILE_POOL_CLASS_COUNT; ++__C)
+        TILE_POOL_FREE(blocks[__C], __C, 0);
+}
+inline void* TILE_POOL_ACQUIRE (int __C)
+{
+    if (TILE_POOL_CACHE_STATE != CACHE_DESTROYED) {
+        auto& cache  = TILE_POOL_CACHE;
+        MutexLock cache_lock (cache.lock);
+        auto& blocks = cache.blocks[__C];
+        
+        // Refill an empty list from the depot (ex: a decoding thread
+        // whose tiles are released by the consumer threads).
+        if (blocks.empty()) {
+            MutexLock depot_lock (TILE_POOL.depotLock);
+            auto& depot = TILE_POOL.depot[__C];
+            const size_t count = std::min(depot.size(), TILE_POOL_BATCH);
+            blocks.insert(blocks.end(), depot.end() - count, depot.end());
+            depot.resize(depot.size() - count);
+        }
+        if (blocks.size()) {
+            void* block = blocks.back();
+            blocks.pop_back();
+            TILE_POOL.retained.fetch_sub(TILE_POOL_CLASSES[__C]);
+            TILE_POOL.hits.fetch_add(1, std::memory_order_relaxed);
+            return block;
+        }
+    }
+    TILE_POOL.misses.fetch_add(1, std::memory_order_relaxed);
+    size_t capacity = TILE_POOL_CLASSES[__C];
+    return ALLOCATE_BLOCK(capacity, BUFFER_CREATE_ALIGNED);
+}
+inline bool TILE_POOL_RELEASE (int __C, void* block)
+{
+    const size_t bytes = TILE_POOL_CLASSES[__C];
+    if (TILE_POOL.retained.fetch_add(bytes) + bytes > TILE_POOL.limit.load(std::memory_order_relaxed)) {
+        TILE_POOL.retained.fetch_sub(bytes);
+        TILE_POOL.evictions.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // If the thread is exiting and the cache is gone, free the block.
+    if (TILE_POOL_CACHE_STATE == CACHE_DESTROYED) {
+        TILE_POOL.retained.fetch_sub(bytes);
+        return false;
+    }
+    auto& cache  = TILE_POOL_CACHE;
+    MutexLock cache_lock (cache.lock);
+    auto& blocks = cache.blocks[__C];
+    blocks.push_back(block);
+    
+    // Spill an over-full list into the depot, keeping one batch.
+    if (blocks.size() > IRIS_TILE_POOL_THREAD_BLOCKS) {
+        const size_t count = blocks.size() - TILE_POOL_BATCH;
+        MutexLock depot_lock (TILE_POOL.depotLock);
+        TILE_POOL.depot[__C].insert(TILE_POOL.depot[__C].end(), blocks.end() - count, blocks.end());
+        blocks.resize(TILE_POOL_BATCH);
+    }
+    TILE_POOL.releases.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+// Buffer deleter: hands the data block back to the destroying thread's
+// free list of the size class it was created in, if its capacity is still
+// that of the class. Otherwise the buffer frees the block normally.
+struct __TILE_POOL_DELETER {
+    int __C;
+    void operator() (__INTERNAL__Buffer* buffer) const
+    {
+        if (buffer->get_strength() == REFERENCE_STRONG &&
+            buffer->get_flags() == BUFFER_CREATE_ALIGNED && buffer->data() &&
+            buffer->capacity() == TILE_POOL_CLASSES[__C] &&
+            TILE_POOL_RELEASE(__C, buffer->data()))
+            buffer->change_strength(REFERENCE_WEAK);
+        delete buffer;
+    }
+};
+} // END ANONYMOUS NAMESPACE
+Buffer Create_tile_buffer (uint8_t channels)
+{
+    int __C = TILE_POOL_CLASS(TILE_PIX_AREA * channels);
+    if (__C < 0) return Create_strong_buffer(TILE_PIX_AREA * channels);
+    
+    void* block = TILE_POOL_ACQUIRE(__C);
+    if (block == nullptr) return nullptr;
+    
+    // Wrap the block and then adopt ownership of it. The size is
+    // reset to 0 as a tile buffer is returned empty like Create_strong_buffer.
+    auto buffer = new __INTERNAL__Buffer(REFERENCE_WEAK, block, TILE_POOL_CLASSES[__C]);
+    buffer->_flags          = BUFFER_CREATE_ALIGNED;
+    buffer->change_strength (REFERENCE_STRONG);
+    buffer->set_size        (0);
+    return Buffer(buffer, __TILE_POOL_DELETER {__C});
+}
+void Set_tile_buffer_pool_limit (size_t bytes)
+{
+    TILE_POOL.limit.store(bytes);
+    
+    // Free the blocks retained beyond the new limit, those
+    // of the depot first and then those of each thread list.
+    {   MutexLock depot_lock (TILE_POOL.depotLock);
+        for (size_t __C = 0; __C < TILE_POOL_CLASS_COUNT; ++__C)
+            TILE_POOL_FREE(TILE_POOL.depot[__C], __C, bytes);
+    }
+    MutexLock registry_lock (TILE_POOL.registryLock);
+    for (auto cache : TILE_POOL.caches) {
+        MutexLock cache_lock (cache->lock);
+        for (size_t __C = 0; __C < TILE_POOL_CLASS_COUNT; ++__C)
+            TILE_POOL_FREE(cache->blocks[__C], __C, bytes);
+    }
+}
+void Trim_tile_buffer_pool ()
+{
+    {   MutexLock depot_lock (TILE_POOL.depotLock);
+        for (size_t __C = 0; __C < TILE_POOL_CLASS_COUNT; ++__C)
+            TILE_POOL_FREE(TILE_POOL.depot[__C], __C, 0);
+    }
+    if (TILE_POOL_CACHE_STATE != CACHE_ALIVE) return;
+    auto& cache = TILE_POOL_CACHE;
+    MutexLock cache_lock (cache.lock);
+    for (size_t __C = 0; __C < TILE_POOL_CLASS_COUNT; ++__C)
+        TILE_POOL_FREE(cache.blocks[__C], __C, 0);
+}
+TileBufferPoolStats Get_tile_buffer_pool_stats ()
+{
+    return TileBufferPoolStats {
+        .retainedBytes  = TILE_POOL.retained.load(),
+        .retainedLimit  = TILE_POOL.limit.load(),
+        .hits           = TILE_POOL.hits.load(),
+        .misses         = TILE_POOL.misses.load(),
+        .releases       = TILE_POOL.releases.load(),
+        .evictions      = TILE_POOL.evictions.load(),
+    };
 }
 } // END IRIS NAMESPACE
@@ -145,10 +145,10 @@ HWY_API void DOWNSAMPLE_INTO_TILE_2X_AVG(const uint8_t* HWY_RESTRICT src,
     
     const auto twos = Set(d16, 2);
     
-    // Aligned buffers for both input and output
-    alignas(32) uint8_t aligned_src[2 * N];
-    alignas(32) uint8_t aligned_dst[N];
-    
+    // Loads and stores are unaligned (LoadU/StoreU): the sub-tile and
+    // neighbouring pixel offsets are never vector aligned, even within
+    // an aligned tile buffer, and unaligned access of an aligned address
+    // carries no penalty. This avoids staging each vector on the stack.
     for (auto y = 0; y < 128; ++y) {
         const auto row0 = src + (2 * y) * stride;
         const auto row1 = src + (2 * y + 1) * stride;
@@ -156,25 +156,16 @@ HWY_API void DOWNSAMPLE_INTO_TILE_2X_AVG(const uint8_t* HWY_RESTRICT src,
         
         size_t x = 0;
         for (; x * N < 128 * CH - N; x += N) {
-            // Copy first row data to aligned buffer
-            memcpy(aligned_src, row0 + 2 * x, N);
-            memcpy(aligned_src + N, row0 + 2 * x + CH, N);
-            
             // Load and sum first row
-            auto sum = PromoteTo(d16, Load(d8, aligned_src));
-            sum += PromoteTo(d16, Load(d8, aligned_src + N));
-            
-            // Copy second row data
-            memcpy(aligned_src, row1 + 2 * x, N);
-            memcpy(aligned_src + N, row1 + 2 * x + CH, N);
+            auto sum = PromoteTo(d16, LoadU(d8, row0 + 2 * x));
+            sum += PromoteTo(d16, LoadU(d8, row0 + 2 * x + CH));
             
             // Add second row
-            sum += PromoteTo(d16, Load(d8, aligned_src));
-            sum += PromoteTo(d16, Load(d8, aligned_src + N));
+            sum += PromoteTo(d16, LoadU(d8, row1 + 2 * x));
+            sum += PromoteTo(d16, LoadU(d8, row1 + 2 * x + CH));
             
             // Average and store
-            Store(DemoteTo(d8, (sum + twos) >> twos), d8, aligned_dst);
-            memcpy(orow + x, aligned_dst, N);
+            StoreU(DemoteTo(d8, (sum + twos) >> twos), d8, orow + x);
         }
         
         // Scalar cleanup
@@ -323,6 +314,7 @@ Buffer Convert_tile_format (const Buffer &src, Format s_fmt, Format d_fmt, const
             dst = src;
         else memcpy(dst->data(), src->data(), src->size());
         dst->set_size(src->size());
+        dst->set_format(d_fmt);
         return dst;
     }
     
@@ -369,7 +361,7 @@ Buffer Convert_tile_format (const Buffer &src, Format s_fmt, Format d_fmt, const
         default: throw std::runtime_error
             ("Convert_tile_format unsupported bits-per-pixel destination format (not 3 or 4 bpp)");
     } if (!dst || dst->capacity() < TILE_PIX_AREA * d_bpp)
-        dst = Create_strong_buffer(TILE_PIX_AREA * d_bpp);
+        dst = Create_tile_buffer(d_bpp);
     
     // Task Selection
     // 1) Task number of channels
@@ -423,7 +415,7 @@ Buffer Convert_tile_format (const Buffer &src, Format s_fmt, Format d_fmt, const
         HWY_STATIC_DISPATCH(SHRINK_TILE_RM_ALPHA_8bit)((uint8_t*)src->data(), (uint8_t*)dst->data());
     } else {
         if (src->data() != dst->data())
-            memcpy(dst->data(), src->data(), dst->size());
+            memcpy(dst->data(), src->data(), TILE_PIX_AREA * d_bpp);
     }
     // byte-swap functions
     if (tasks & TASK_SWAP_0_2) {
@@ -440,6 +432,7 @@ Buffer Convert_tile_format (const Buffer &src, Format s_fmt, Format d_fmt, const
     
     // Ensure the size is correct before returning
     dst->set_size(TILE_PIX_AREA * d_bpp);
+    dst->set_format(d_fmt);
     return dst;
 }
 namespace N = hwy::HWY_NAMESPACE;